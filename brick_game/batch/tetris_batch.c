@@ -0,0 +1,94 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Утилита пакетного моделирования игр tetris-batch.
+
+  Утилита выполняет заданное количество игр ботом на всех ядрах процессора и
+  выводит сводную статистику: скорость моделирования, количество фигур и строк,
+  распределение набранных очков.
+
+  Использование:
+    tetris-batch [-n игры] [-j потоки] [-s зерно] [-p uniform|bag7|history]
+                 [-a тактов_на_действие] [-t предел_тактов]
+                 [-r каталог_повторов]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../tetris/batch.h"
+
+static void printUsage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [-n games] [-j workers] [-s seed] "
+          "[-p uniform|bag7|history] [-a ticks_per_action] [-t max_ticks] "
+          "[-r replay_dir]\n",
+          name);
+}
+
+static int parsePolicy(const char *value, tetSequencePolicy_t *policy) {
+  int err = 0;
+  if (!strcmp(value, "uniform"))
+    *policy = SequenceUniform;
+  else if (!strcmp(value, "bag7"))
+    *policy = SequenceBag7;
+  else if (!strcmp(value, "history"))
+    *policy = SequenceHistory;
+  else
+    err = 1;
+  return err;
+}
+
+int main(int argc, char *argv[]) {
+  BatchConfig_t config;
+  BatchResult_t result;
+  int err = 0, opt = 0;
+
+  initBatchConfig(&config);
+  while (!err && (opt = getopt(argc, argv, "n:j:s:p:a:t:r:h")) != -1) {
+    if (opt == 'n')
+      config.games = atoi(optarg);
+    else if (opt == 'j')
+      config.workers = atoi(optarg);
+    else if (opt == 's')
+      config.seed = strtoull(optarg, NULL, 0);
+    else if (opt == 'p')
+      err = parsePolicy(optarg, &config.policy);
+    else if (opt == 'a')
+      config.ticksPerAction = atoi(optarg);
+    else if (opt == 't')
+      config.maxTicks = strtoull(optarg, NULL, 0);
+    else if (opt == 'r')
+      config.replayDir = optarg;
+    else
+      err = 1;
+  }
+
+  if (err) {
+    printUsage(argv[0]);
+  } else if ((err = runBatch(&config, &result)) != 0) {
+    fprintf(stderr, "%s: batch simulation failed\n", argv[0]);
+  } else {
+    printf("games:        %d\n", result.games);
+    printf("workers:      %d\n", result.workers);
+    printf("time:         %.3f s\n", result.seconds);
+    printf("pieces:       %lld (%.0f pieces/s)\n", result.pieces,
+           result.piecesPerSecond);
+    printf("lines:        %lld (%.2f per game)\n", result.lines,
+           (double)result.lines / result.games);
+    printf("ticks:        %lld (%.0f ticks/s)\n", result.ticks,
+           result.seconds > 0 ? (double)result.ticks / result.seconds : 0.0);
+    printf("score:        min %d / median %d / mean %.1f / p90 %d / max %d\n",
+           result.minScore, result.medianScore, result.meanScore,
+           result.p90Score, result.maxScore);
+    freeBatchResult(&result);
+  }
+
+  return err;
+}
@@ -0,0 +1,74 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Утилита воспроизведения повторов tetris-replay.
+
+  Утилита воспроизводит повтор без интерфейса с максимальной скоростью и
+  выводит итоговое состояние игры и контрольную сумму игрового поля, что
+  позволяет использовать повторы в регрессионных тестах.
+
+  Использование:
+    tetris-replay файл_повтора
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "../tetris/replay.h"
+
+static uint64_t boardChecksum(const BitBoard_t *board) {
+  const uint8_t *bytes = (const uint8_t *)board;
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (size_t i = 0; i < sizeof(*board); i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+int main(int argc, char *argv[]) {
+  ReplayReader_t reader;
+  Game_t *game = NULL;
+  int err = 0;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s replay_file\n", argv[0]);
+    err = 1;
+  } else if (replayOpenRead(&reader, argv[1])) {
+    fprintf(stderr, "%s: cannot read replay '%s'\n", argv[0], argv[1]);
+    err = 1;
+  } else if ((game = createGameCtx()) == NULL) {
+    replayCloseRead(&reader);
+    err = 1;
+  } else {
+    struct timespec start = {0}, finish = {0};
+    double seconds = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    err = replayPlay(&reader, game);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    seconds = (double)(finish.tv_sec - start.tv_sec) +
+              (double)(finish.tv_nsec - start.tv_nsec) / 1e9;
+    if (err) {
+      fprintf(stderr, "%s: replay does not match this build\n", argv[0]);
+    } else {
+      printf("seed:     %llu\n", (unsigned long long)reader.header.seed);
+      printf("ticks:    %llu (%.0f ticks/s)\n",
+             (unsigned long long)game->core.tick,
+             seconds > 0 ? (double)game->core.tick / seconds : 0.0);
+      printf("state:    %d\n", (int)game->core.state);
+      printf("score:    %d\n", game->gameInfo ? game->core.score : 0);
+      printf("lines:    %d\n", game->core.lines);
+      printf("pieces:   %d\n", game->core.pieces);
+      printf("board:    %016llx\n",
+             (unsigned long long)boardChecksum(&game->core.board));
+    }
+    replayCloseRead(&reader);
+    destroyGame(game);
+  }
+
+  return err;
+}
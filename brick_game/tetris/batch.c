@@ -0,0 +1,333 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации пакетного моделирования игр.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bot.h"
+#include "replay.h"
+
+/*!
+  \brief Структура очереди игр рабочего потока.
+
+  Очередь хранит полуинтервал индексов игр [head, tail) в одном атомарном
+  64-битном слове: старшие 32 бита - head, младшие - tail. Владелец забирает
+  игры с головы, другие потоки перехватывают половину интервала с хвоста.
+*/
+typedef struct BatchQueue_t {
+  _Alignas(64) _Atomic uint64_t range;  ///< Упакованный интервал индексов.
+} BatchQueue_t;
+
+/*!
+  \brief Структура общих данных пакета.
+*/
+typedef struct BatchShared_t {
+  const BatchConfig_t *config;  ///< Параметры моделирования.
+  BatchQueue_t *queues;  ///< Очереди рабочих потоков.
+  int workers;  ///< Количество рабочих потоков.
+  BatchGameResult_t *results;  ///< Результаты отдельных игр.
+  _Atomic int played;  ///< Количество выполненных игр.
+} BatchShared_t;
+
+/*!
+  \brief Структура параметров рабочего потока.
+*/
+typedef struct BatchWorker_t {
+  BatchShared_t *shared;  ///< Общие данные пакета.
+  int id;  ///< Номер потока.
+} BatchWorker_t;
+
+static uint64_t packRange(uint32_t head, uint32_t tail) {
+  return ((uint64_t)head << 32) | tail;
+}
+
+/*!
+  \brief Функция получения игры из собственной очереди.
+  \return 1 - игра получена, 0 - очередь пуста.
+*/
+static int queuePop(BatchQueue_t *queue, uint32_t *index) {
+  uint64_t range = atomic_load(&queue->range);
+  int found = 0;
+
+  while (!found && (uint32_t)(range >> 32) < (uint32_t)range) {
+    uint32_t head = (uint32_t)(range >> 32);
+    if (atomic_compare_exchange_weak(&queue->range, &range,
+                                     packRange(head + 1, (uint32_t)range))) {
+      *index = head;
+      found = 1;
+    }
+  }
+
+  return found;
+}
+
+/*!
+  \brief Функция перехвата половины игр из очереди другого потока.
+  \return 1 - игры перехвачены в интервал [*begin, *end), 0 - очередь пуста.
+*/
+static int queueSteal(BatchQueue_t *victim, uint32_t *begin, uint32_t *end) {
+  uint64_t range = atomic_load(&victim->range);
+  int stolen = 0;
+
+  while (!stolen && (uint32_t)(range >> 32) < (uint32_t)range) {
+    uint32_t head = (uint32_t)(range >> 32), tail = (uint32_t)range;
+    uint32_t take = (tail - head + 1) / 2;
+    if (atomic_compare_exchange_weak(&victim->range, &range,
+                                     packRange(head, tail - take))) {
+      *begin = tail - take;
+      *end = tail;
+      stolen = 1;
+    }
+  }
+
+  return stolen;
+}
+
+/*!
+  \brief Функция моделирования одной игры пакета.
+
+  Если задан каталог повторов, действия бота записываются в файл
+  game_<индекс>.s21r этого каталога. Игра размещается в области памяти на стеке
+  потока и не обращается к общему распределителю памяти.
+*/
+static void playBatchGame(const BatchConfig_t *config, uint32_t index,
+                          BatchGameResult_t *result) {
+  GameArena_t arena;
+  Game_t *game = createGameIn(&arena, sizeof(arena));
+  ReplayWriter_t *writer = NULL;
+  BotPlan_t plan;
+
+  memset(result, 0, sizeof(*result));
+  if (game) {
+    botReset(&plan);
+    seedGame(game, config->seed + index, config->policy);
+    if (config->replayDir &&
+        (writer = (ReplayWriter_t *)malloc(sizeof(ReplayWriter_t)))) {
+      char path[FILENAME_MAX];
+      snprintf(path, sizeof(path), "%s/game_%u.s21r", config->replayDir,
+               (unsigned)index);
+      if (replayOpenWrite(writer, path, game)) {
+        free(writer);
+        writer = NULL;
+      }
+    }
+    fsm_state_t state = tetris_step(game, Start, 0);
+    while (state != fsm_gameover && state != fsm_exit &&
+           game->core.tick < config->maxTicks)
+      state = tetris_step(game, botChooseAction(game, &plan),
+                          config->ticksPerAction);
+    result->score = game->gameInfo ? game->core.score : 0;
+    result->lines = game->core.lines;
+    result->pieces = game->core.pieces;
+    result->ticks = game->core.tick;
+    if (writer) {
+      replayCloseWrite(writer, game);
+      free(writer);
+    }
+    destroyGame(game);
+  }
+}
+
+/*!
+  \brief Функция рабочего потока.
+
+  Поток выполняет игры из своей очереди, а после ее исчерпания перехватывает
+  игры у других потоков. Поток завершается, когда все очереди пусты.
+*/
+static void *batchWorker(void *arg) {
+  BatchWorker_t *worker = (BatchWorker_t *)arg;
+  BatchShared_t *shared = worker->shared;
+  BatchQueue_t *own = &shared->queues[worker->id];
+  int working = 1;
+
+  while (working) {
+    uint32_t index = 0, begin = 0, end = 0;
+    if (queuePop(own, &index)) {
+      playBatchGame(shared->config, index, &shared->results[index]);
+      atomic_fetch_add(&shared->played, 1);
+    } else {
+      working = 0;
+      for (int i = 1; i < shared->workers && !working; i++) {
+        int victim = (worker->id + i) % shared->workers;
+        if (queueSteal(&shared->queues[victim], &begin, &end)) {
+          atomic_store(&own->range, packRange(begin, end));
+          working = 1;
+        }
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static int compareInt(const void *a, const void *b) {
+  int left = *(const int *)a, right = *(const int *)b;
+  return (left > right) - (left < right);
+}
+
+/*!
+  \ingroup Batch_simulation Функции пакетного моделирования
+  \brief Функция подсчета сводных показателей пакета.
+  \param [in,out] result Указатель на структуру сводного результата с
+  заполненными полями games, seconds и results и нулевыми суммами.
+  \return 0 - успешное выполнение, 1 - нет результатов или ошибка выделения
+  памяти.
+
+  Суммы фигур, строк и тактов накапливаются по результатам отдельных игр.
+  Медиана и 90-й процентиль - элементы отсортированных результатов с
+  индексами games / 2 и games * 9 / 10.
+*/
+int summarizeBatch(BatchResult_t *result) {
+  int *scores = NULL;
+  int err = !result || result->games <= 0 || !result->results;
+
+  if (!err) {
+    scores = (int *)malloc(sizeof(int) * (size_t)result->games);
+    err = scores == NULL;
+  }
+
+  if (!err) {
+    long long total = 0;
+    for (int i = 0; i < result->games; i++) {
+      scores[i] = result->results[i].score;
+      total += scores[i];
+      result->pieces += result->results[i].pieces;
+      result->lines += result->results[i].lines;
+      result->ticks += (long long)result->results[i].ticks;
+    }
+    qsort(scores, (size_t)result->games, sizeof(int), compareInt);
+    result->meanScore = (double)total / result->games;
+    result->minScore = scores[0];
+    result->medianScore = scores[result->games / 2];
+    result->p90Score = scores[(size_t)result->games * 9 / 10];
+    result->maxScore = scores[result->games - 1];
+    if (result->seconds > 0)
+      result->piecesPerSecond = (double)result->pieces / result->seconds;
+    free(scores);
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Batch_simulation Функции пакетного моделирования
+  \brief Функция заполнения параметров моделирования значениями по умолчанию.
+  \param [out] config Указатель на структуру BatchConfig_t.
+*/
+void initBatchConfig(BatchConfig_t *config) {
+  if (config) {
+    config->games = 1000;
+    config->workers = 0;
+    config->seed = GAME_DEFAULT_SEED;
+    config->policy = SequenceBag7;
+    config->ticksPerAction = BATCH_TICKS_PER_ACTION;
+    config->maxTicks = BATCH_MAX_TICKS;
+    config->replayDir = NULL;
+  }
+}
+
+/*!
+  \ingroup Batch_simulation Функции пакетного моделирования
+  \brief Функция пакетного моделирования игр.
+  \param [in] config Указатель на параметры моделирования.
+  \param [out] result Указатель на структуру сводного результата.
+  \return 0 - успешное выполнение, 1 - ошибка параметров, выделения памяти или
+  создания потоков.
+
+  Игры изначально делятся между потоками поровну, дальнейшая балансировка
+  выполняется перехватом работы. После успешного выполнения результаты
+  отдельных игр необходимо освободить функцией freeBatchResult().
+*/
+int runBatch(const BatchConfig_t *config, BatchResult_t *result) {
+  int err = !config || !result || config->games <= 0 ||
+            config->ticksPerAction <= 0;
+  BatchShared_t shared = {0};
+  BatchWorker_t *workers = NULL;
+  pthread_t *threads = NULL;
+  struct timespec start = {0}, finish = {0};
+
+  if (!err) {
+    memset(result, 0, sizeof(*result));
+    shared.config = config;
+    shared.workers = config->workers > 0
+                         ? config->workers
+                         : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (shared.workers <= 0) shared.workers = 1;
+    if (shared.workers > config->games) shared.workers = config->games;
+    shared.results = (BatchGameResult_t *)calloc((size_t)config->games,
+                                                 sizeof(BatchGameResult_t));
+    shared.queues = (BatchQueue_t *)aligned_alloc(
+        _Alignof(BatchQueue_t),
+        sizeof(BatchQueue_t) * (size_t)shared.workers);
+    workers = (BatchWorker_t *)malloc(sizeof(BatchWorker_t) *
+                                      (size_t)shared.workers);
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * (size_t)shared.workers);
+    err = !shared.results || !shared.queues || !workers || !threads;
+  }
+
+  if (!err) {
+    int started = 0;
+    for (int i = 0; i < shared.workers; i++) {
+      uint32_t begin = (uint32_t)((long long)config->games * i / shared.workers);
+      uint32_t end =
+          (uint32_t)((long long)config->games * (i + 1) / shared.workers);
+      atomic_init(&shared.queues[i].range, packRange(begin, end));
+      workers[i].shared = &shared;
+      workers[i].id = i;
+    }
+    atomic_init(&shared.played, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (; started < shared.workers; started++)
+      if (pthread_create(&threads[started], NULL, batchWorker,
+                         &workers[started]))
+        break;
+    if (started == 0) err = 1;
+    if (!err && started < shared.workers) batchWorker(&workers[started]);
+    for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+  }
+
+  if (!err) {
+    result->games = config->games;
+    result->played = atomic_load(&shared.played);
+    result->workers = shared.workers;
+    result->results = shared.results;
+    result->seconds = (double)(finish.tv_sec - start.tv_sec) +
+                      (double)(finish.tv_nsec - start.tv_nsec) / 1e9;
+    shared.results = NULL;
+    err = summarizeBatch(result);
+  }
+
+  free(shared.results);
+  free(shared.queues);
+  free(workers);
+  free(threads);
+
+  return err;
+}
+
+/*!
+  \ingroup Batch_simulation Функции пакетного моделирования
+  \brief Функция освобождения результатов отдельных игр пакета.
+  \param [in,out] result Указатель на структуру сводного результата.
+*/
+void freeBatchResult(BatchResult_t *result) {
+  if (result) {
+    free(result->results);
+    result->results = NULL;
+  }
+}
@@ -0,0 +1,85 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл пакетного моделирования игр.
+
+  Пакетное моделирование выполняет заданное количество независимых игр без
+  интерфейса на пуле рабочих потоков. Каждая игра получает собственный
+  экземпляр Game_t и зерно генератора фигур, поэтому результаты не зависят от
+  количества потоков и порядка выполнения. Игры распределяются между потоками
+  с перехватом работы (work stealing): поток, исчерпавший свою очередь, забирает
+  половину оставшихся игр из очереди другого потока.
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "tetris.h"
+
+/*!
+  \brief Количество логических тактов между действиями бота по умолчанию.
+*/
+#define BATCH_TICKS_PER_ACTION 1
+
+/*!
+  \brief Предельное количество логических тактов одной игры по умолчанию.
+*/
+#define BATCH_MAX_TICKS 10000000ull
+
+/*!
+  \brief Структура параметров пакетного моделирования.
+*/
+typedef struct BatchConfig_t {
+  int games;  ///< Количество моделируемых игр.
+  int workers;  ///< Количество рабочих потоков (0 - по числу процессоров).
+  uint64_t seed;  ///< Базовое зерно; игра i получает зерно seed + i.
+  tetSequencePolicy_t policy;  ///< Политика последовательности фигур.
+  int ticksPerAction;  ///< Количество тактов между действиями бота.
+  uint64_t maxTicks;  ///< Предельное количество тактов одной игры.
+  const char *replayDir;  ///< Каталог для записи повторов игр или NULL.
+} BatchConfig_t;
+
+/*!
+  \brief Структура результата одной игры пакета.
+*/
+typedef struct BatchGameResult_t {
+  int score;   ///< Набранные очки.
+  int lines;   ///< Удаленные строки.
+  int pieces;  ///< Зафиксированные фигуры.
+  uint64_t ticks;  ///< Логические такты игры.
+} BatchGameResult_t;
+
+/*!
+  \brief Структура сводного результата пакетного моделирования.
+*/
+typedef struct BatchResult_t {
+  int games;    ///< Количество сыгранных игр.
+  int played;   ///< Количество игр, выполненных рабочими потоками (совпадает
+                ///< с games: каждая игра выполняется один раз).
+  int workers;  ///< Количество использованных потоков.
+  long long pieces;  ///< Суммарное количество фигур.
+  long long lines;   ///< Суммарное количество удаленных строк.
+  long long ticks;   ///< Суммарное количество логических тактов.
+  double seconds;    ///< Время моделирования в секундах.
+  double piecesPerSecond;  ///< Скорость моделирования в фигурах в секунду.
+  double meanScore;  ///< Средний результат.
+  int minScore;      ///< Минимальный результат.
+  int medianScore;   ///< Медиана результатов.
+  int p90Score;      ///< 90-й процентиль результатов.
+  int maxScore;      ///< Максимальный результат.
+  BatchGameResult_t *results;  ///< Результаты отдельных игр (games элементов),
+                               ///< освобождаются функцией freeBatchResult().
+} BatchResult_t;
+
+/*!
+  \defgroup Batch_simulation Функции пакетного моделирования
+  \brief Функции выполнения множества игр без интерфейса.
+*/
+void initBatchConfig(BatchConfig_t *config);
+int runBatch(const BatchConfig_t *config, BatchResult_t *result);
+int summarizeBatch(BatchResult_t *result);
+void freeBatchResult(BatchResult_t *result);
+
+#endif  // BATCH_H
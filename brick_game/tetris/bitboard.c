@@ -0,0 +1,515 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации функций битового представления игрового поля.
+*/
+
+#include "bitboard.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*!
+  \brief Функция смещения маски строки фигуры на столбец игрового поля.
+  \param [in] mask Маска строки фигуры в локальных координатах фигуры.
+  \param [in] col Смещение фигуры по горизонтали.
+  \param [out] placed Маска строки в координатах игрового поля.
+  \return 1 - если строка фигуры помещается между стенками поля, 0 - если
+  хотя бы одна ячейка выходит за боковые границы.
+*/
+static int bbPlaceRow(bbrow_t mask, int col, bbrow_t *placed) {
+  uint32_t wide = mask;
+  int fits = 1;
+
+  if (col <= -16 || col >= 16) {
+    fits = (wide == 0);
+    wide = 0;
+  } else if (col < 0) {
+    if (wide & ((1u << -col) - 1u)) fits = 0;
+    wide >>= -col;
+  } else {
+    wide <<= col;
+  }
+  if (wide & ~(uint32_t)BB_FULL_ROW) fits = 0;
+  *placed = (bbrow_t)(wide & BB_FULL_ROW);
+
+  return fits;
+}
+
+/*!
+  \brief Функция подсчета единичных бит слова множества строк.
+*/
+static int bbBitCount(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(bits);
+#else
+  int count = 0;
+  for (; bits; bits &= bits - 1) count++;
+  return count;
+#endif
+}
+
+/*!
+  \brief Функция поиска старшего единичного бита непустого слова множества
+  строк.
+*/
+static int bbHighestBit(uint64_t bits) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(bits);
+#else
+  int bit = 0;
+  while (bits >>= 1) bit++;
+  return bit;
+#endif
+}
+
+/*!
+  \brief Функция удаления строк массива, построчно описывающего поле.
+  \param [in,out] rows Массив из GAME_BOARD_HEIGHT элементов.
+  \param [in] size Размер элемента массива в байтах.
+  \param [in] cleared Множество удаляемых строк.
+
+  Удаляемые строки перебираются снизу вверх. Отрезок строк между соседними
+  удаляемыми строками переносится одним memmove() на количество удаленных
+  ниже него строк, освободившиеся верхние элементы обнуляются.
+*/
+static void bbCompactRows(void *rows, size_t size,
+                          const BoardRowSet_t *cleared) {
+  unsigned char *base = rows;
+  int shift = 0, prev = GAME_BOARD_HEIGHT;
+
+  for (int w = BB_ROWSET_WORDS - 1; w >= 0; w--) {
+    for (uint64_t bits = cleared->words[w]; bits;) {
+      int bit = bbHighestBit(bits);
+      int row = w * 64 + bit;
+      bits &= ~(UINT64_C(1) << bit);
+      if (shift && prev - row > 1)
+        memmove(base + (size_t)(row + 1 + shift) * size,
+                base + (size_t)(row + 1) * size,
+                (size_t)(prev - row - 1) * size);
+      shift++;
+      prev = row;
+    }
+  }
+  if (shift) {
+    memmove(base + (size_t)shift * size, base, (size_t)prev * size);
+    memset(base, 0, (size_t)shift * size);
+  }
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция очистки битового игрового поля.
+  \param [out] board Указатель на структуру BitBoard_t.
+  \param [out] colors Указатель на цветовую плоскость поля или NULL.
+
+  Ячейки поля очищаются, сторожевая рамка заполняется: во всех строках
+  заняты стенки, строки пола заняты полностью.
+*/
+void bbClear(BitBoard_t *board, BoardColors_t *colors) {
+  if (colors) memset(colors, 0, sizeof(*colors));
+  if (board) {
+    for (int i = 0; i < BB_PAD + GAME_BOARD_HEIGHT; i++)
+      board->rows[i] = BB_WALLS;
+    for (int i = BB_PAD + GAME_BOARD_HEIGHT; i < BB_ROWS; i++)
+      board->rows[i] = BB_SOLID_ROW;
+  }
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция получения значения (цвета) ячейки битового игрового поля.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] colors Указатель на цветовую плоскость поля или NULL.
+  \param [in] row Координата строки ячейки.
+  \param [in] col Координата столбца ячейки.
+  \return Значение ячейки (0 - пустая ячейка) или -1 при выходе за границы
+  поля или отсутствии указателя. Занятая ячейка без цвета имеет значение
+  BB_DEFAULT_COLOR.
+*/
+int bbGetCell(const BitBoard_t *board, const BoardColors_t *colors, int row,
+              int col) {
+  int val = -1;
+  if (board && row >= 0 && row < GAME_BOARD_HEIGHT && col >= 0 &&
+      col < GAME_BOARD_WIDTH) {
+    val = 0;
+    if ((BB_ROW_CELLS(board, row) >> col) & 1u) {
+      if (colors)
+        val = (int)((colors->rows[row] >> (col * BB_COLOR_BITS)) &
+                    BB_COLOR_MASK);
+      if (!val) val = BB_DEFAULT_COLOR;
+    }
+  }
+  return val;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция изменения значения (цвета) ячейки битового игрового поля.
+  \param [in,out] board Указатель на структуру BitBoard_t.
+  \param [in,out] colors Указатель на цветовую плоскость поля или NULL.
+  \param [in] row Координата строки ячейки.
+  \param [in] col Координата столбца ячейки.
+  \param [in] val Значение ячейки от 0 (пустая ячейка) до BB_COLOR_MASK.
+  \return 0 - успешное выполнение изменений, 1 - ошибка выполнения.
+
+  Функция синхронно изменяет маску занятых ячеек и цветовую плоскость.
+*/
+int bbSetCell(BitBoard_t *board, BoardColors_t *colors, int row, int col,
+              int val) {
+  int err = 1;
+  if (board && row >= 0 && row < GAME_BOARD_HEIGHT && col >= 0 &&
+      col < GAME_BOARD_WIDTH && val >= 0 && val <= (int)BB_COLOR_MASK) {
+    int shift = col * BB_COLOR_BITS;
+    if (colors)
+      colors->rows[row] = (colors->rows[row] & ~(BB_COLOR_MASK << shift)) |
+                          ((bbcolor_t)val << shift);
+    if (val)
+      board->rows[row + BB_PAD] |= (bbrow_t)(1u << (col + BB_PAD));
+    else
+      board->rows[row + BB_PAD] &= (bbrow_t) ~(1u << (col + BB_PAD));
+    err = 0;
+  }
+  return err;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция проверки коллизии фигуры с игровым полем.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] mask Массив масок строк фигуры в локальных координатах.
+  \param [in] nrows Количество строк в массиве mask.
+  \param [in] row Смещение верхней строки фигуры относительно поля.
+  \param [in] col Смещение левого столбца фигуры относительно поля.
+  \return 0 - если пересечений нет, 1 - при наличии коллизий.
+
+  Выход за боковые границы и дно поля обнаруживается по сторожевой рамке,
+  поэтому каждая строка фигуры проверяется одной операцией AND без ветвлений,
+  а строки фигуры выше верхней границы поля проверяются только на выход за
+  боковые границы. Положение, при котором маска фигуры не помещается в
+  сторожевую рамку (все ячейки фигуры вне поля), считается коллизией.
+*/
+int bbCollides(const BitBoard_t *board, const bbrow_t *mask, int nrows,
+               int row, int col) {
+  int isCollided = 1;
+  int shift = col + BB_PAD;
+
+  if (board && mask && shift >= 0 && shift <= BB_SHIFT_MAX &&
+      row >= -BB_PAD && row + nrows <= GAME_BOARD_HEIGHT + BB_PAD) {
+    const bbrow_t *rows = board->rows + BB_PAD + row;
+    unsigned hit = 0;
+    for (int i = 0; i < nrows; i++)
+      hit |= rows[i] & ((unsigned)mask[i] << shift);
+    isCollided = (hit != 0);
+  }
+
+  return isCollided;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция фиксации (объединения) фигуры с игровым полем.
+  \param [in,out] board Указатель на структуру BitBoard_t.
+  \param [in,out] colors Указатель на цветовую плоскость поля или NULL.
+  \param [in] mask Массив масок строк фигуры в локальных координатах.
+  \param [in] nrows Количество строк в массиве mask.
+  \param [in] row Смещение верхней строки фигуры относительно поля.
+  \param [in] col Смещение левого столбца фигуры относительно поля.
+  \param [in] val Значение (цвет) ячеек фигуры.
+  \return 0 - успешное выполнение, 1 - если фигура выходит за границы поля
+  или значение цвета недопустимо (поле при этом не изменяется).
+*/
+int bbLock(BitBoard_t *board, BoardColors_t *colors, const bbrow_t *mask,
+           int nrows, int row, int col, int val) {
+  int err = 0;
+
+  if (!board || !mask || val <= 0 || val > (int)BB_COLOR_MASK) err = 1;
+  for (int i = 0; i < nrows && !err; i++) {
+    bbrow_t placed = 0;
+    int boardRow = row + i;
+    if (mask[i] && (!bbPlaceRow(mask[i], col, &placed) || boardRow < 0 ||
+                    boardRow >= GAME_BOARD_HEIGHT))
+      err = 1;
+  }
+
+  for (int i = 0; i < nrows && !err; i++) {
+    bbrow_t placed = 0;
+    int boardRow = row + i;
+    if (!mask[i]) continue;
+    bbPlaceRow(mask[i], col, &placed);
+    board->rows[boardRow + BB_PAD] |= (bbrow_t)(placed << BB_PAD);
+    for (int c = 0; colors && placed; c++, placed >>= 1) {
+      if (placed & 1u) {
+        int shift = c * BB_COLOR_BITS;
+        colors->rows[boardRow] =
+            (colors->rows[boardRow] & ~(BB_COLOR_MASK << shift)) |
+            ((bbcolor_t)val << shift);
+      }
+    }
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция проверки заполненности строки игрового поля.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] row Координата строки.
+  \return 1 - строка заполнена полностью, 0 - в остальных случаях.
+*/
+int bbIsRowFull(const BitBoard_t *board, int row) {
+  return board && row >= 0 && row < GAME_BOARD_HEIGHT &&
+         board->rows[row + BB_PAD] == BB_SOLID_ROW;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция поиска заполненных строк игрового поля.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [out] full Множество заполненных строк.
+  \return Количество заполненных строк.
+
+  Хранимые строки сравниваются с BB_SOLID_ROW по восемь за одну операцию SSE2,
+  результаты сравнения упаковываются в биты множества; оставшиеся строки и
+  сборки без SSE2 проверяются по одной. Количество строк - сумма popcount
+  слов множества.
+*/
+int bbFindFullRows(const BitBoard_t *board, BoardRowSet_t *full) {
+  int count = 0;
+
+  if (full) memset(full, 0, sizeof(*full));
+  if (board && full) {
+    int row = 0;
+#if defined(__SSE2__)
+    const __m128i target = _mm_set1_epi16((short)BB_SOLID_ROW);
+    for (; row + 8 <= GAME_BOARD_HEIGHT; row += 8) {
+      __m128i eq = _mm_cmpeq_epi16(
+          _mm_loadu_si128((const __m128i *)(board->rows + BB_PAD + row)),
+          target);
+      uint64_t bits = (uint64_t)_mm_movemask_epi8(
+          _mm_packs_epi16(eq, _mm_setzero_si128()));
+      full->words[row / 64] |= bits << (row % 64);
+    }
+#endif
+    for (; row < GAME_BOARD_HEIGHT; row++)
+      if (board->rows[row + BB_PAD] == BB_SOLID_ROW)
+        full->words[row / 64] |= UINT64_C(1) << (row % 64);
+    for (int w = 0; w < BB_ROWSET_WORDS; w++)
+      count += bbBitCount(full->words[w]);
+  }
+
+  return count;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция удаления заполненных строк игрового поля.
+  \param [in,out] board Указатель на структуру BitBoard_t.
+  \param [in,out] colors Указатель на цветовую плоскость поля или NULL.
+  \param [out] cleared Множество удаленных строк (может быть NULL).
+  \return Количество удаленных строк.
+
+  Незаполненные строки смещаются вниз на место удаленных, освободившиеся
+  верхние строки очищаются (в них остаются только стенки). Строки ниже самой
+  нижней удаленной строки не копируются, остальные переносятся отрезками
+  между удаленными строками.
+*/
+int bbClearFullRows(BitBoard_t *board, BoardColors_t *colors,
+                    BoardRowSet_t *cleared) {
+  BoardRowSet_t full;
+  int count = bbFindFullRows(board, &full);
+
+  if (count) {
+    bbCompactRows(board->rows + BB_PAD, sizeof(board->rows[0]), &full);
+    if (colors) bbCompactRows(colors->rows, sizeof(colors->rows[0]), &full);
+    for (int i = 0; i < count; i++) board->rows[BB_PAD + i] = BB_WALLS;
+  }
+  if (cleared) *cleared = full;
+
+  return count;
+}
+
+/*!
+  \ingroup Bitboard_operations Функции битового игрового поля
+  \brief Функция выгрузки битового поля в двумерный массив значений ячеек.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] colors Указатель на цветовую плоскость поля или NULL.
+  \param [out] field Двумерный массив GAME_BOARD_HEIGHT x GAME_BOARD_WIDTH,
+  созданный функцией createGameField().
+
+  Функция предназначена для получения представления поля, используемого
+  структурой GameInfo_t и функциями отрисовки. Занятость ячеек берется из
+  масок строк, значения - из цветовой плоскости (см. bbGetCell()).
+*/
+void bbExportField(const BitBoard_t *board, const BoardColors_t *colors,
+                   int **field) {
+  if (board && field) {
+    for (int i = 0; i < GAME_BOARD_HEIGHT; i++) {
+      bbrow_t cells = BB_ROW_CELLS(board, i);
+      bbcolor_t color = colors ? colors->rows[i] : 0;
+      for (int j = 0; j < GAME_BOARD_WIDTH; j++) {
+        int val = (int)(color & BB_COLOR_MASK);
+        field[i][j] = (cells & 1u) ? (val ? val : BB_DEFAULT_COLOR) : 0;
+        cells >>= 1;
+        color >>= BB_COLOR_BITS;
+      }
+    }
+  }
+}
+
+/*!
+  \ingroup Profile_operations Функции профиля поверхности поля
+  \brief Функция построения профиля поверхности по игровому полю.
+  \param [out] profile Указатель на структуру BoardProfile_t.
+  \param [in] board Указатель на структуру BitBoard_t.
+
+  Поле обходится один раз сверху вниз, поэтому функция используется только
+  при очистке поля.
+*/
+void bbProfileBuild(BoardProfile_t *profile, const BitBoard_t *board) {
+  if (profile && board) {
+    bbrow_t covered = 0;
+
+    memset(profile, 0, sizeof(*profile));
+    for (int row = 0; row < GAME_BOARD_HEIGHT; row++) {
+      bbrow_t cells = BB_ROW_CELLS(board, row);
+      bbrow_t fresh = (bbrow_t)(cells & ~covered);
+      bbrow_t empty = (bbrow_t)(~cells & covered & BB_FULL_ROW);
+      for (int col = 0; col < GAME_BOARD_WIDTH; col++) {
+        if (fresh & (1u << col))
+          profile->heights[col] = (int8_t)(GAME_BOARD_HEIGHT - row);
+        if (empty & (1u << col)) profile->holes[col]++;
+        if (cells & (1u << col)) profile->rowFill[row]++;
+      }
+      covered |= cells;
+    }
+  }
+}
+
+/*!
+  \ingroup Profile_operations Функции профиля поверхности поля
+  \brief Функция обновления профиля после фиксации фигуры.
+  \param [in,out] profile Указатель на структуру BoardProfile_t.
+  \param [in] mask Массив масок строк фигуры в локальных координатах.
+  \param [in] nrows Количество строк в массиве mask.
+  \param [in] row Смещение верхней строки фигуры относительно поля.
+  \param [in] col Смещение левого столбца фигуры относительно поля.
+
+  Вызывается после успешного выполнения bbLock() с теми же параметрами.
+  Обрабатываются только ячейки фигуры: если фигура подняла столбец, пустые
+  ячейки между прежней и новой вершиной становятся дырами, а ячейки фигуры,
+  заполнившие дыры под навесом, уменьшают их количество.
+*/
+void bbProfileLock(BoardProfile_t *profile, const bbrow_t *mask, int nrows,
+                   int row, int col) {
+  if (profile && mask) {
+    for (int i = nrows - 1; i >= 0; i--) {
+      bbrow_t placed = 0;
+      int boardRow = row + i;
+      if (!mask[i] || boardRow < 0 || boardRow >= GAME_BOARD_HEIGHT) continue;
+      bbPlaceRow(mask[i], col, &placed);
+      for (int c = 0; placed; c++, placed >>= 1) {
+        if (placed & 1u) {
+          int height = GAME_BOARD_HEIGHT - boardRow;
+          if (height > profile->heights[c]) {
+            profile->holes[c] += (int8_t)(height - 1 - profile->heights[c]);
+            profile->heights[c] = (int8_t)height;
+          } else {
+            profile->holes[c]--;
+          }
+          profile->rowFill[boardRow]++;
+        }
+      }
+    }
+  }
+}
+
+/*!
+  \ingroup Profile_operations Функции профиля поверхности поля
+  \brief Функция обновления профиля после удаления заполненных строк.
+  \param [in,out] profile Указатель на структуру BoardProfile_t, обновленную
+  bbProfileLock() до удаления строк.
+  \param [in] board Указатель на структуру BitBoard_t после выполнения
+  bbClearFullRows().
+  \param [in] cleared Множество строк, удаленных bbClearFullRows().
+  \return Количество удаленных строк.
+
+  Счетчики rowFill сдвигаются так же, как строки поля. Каждая удаленная
+  строка понижает все столбцы на одну ячейку, количество дыр при этом не
+  меняется. Поле читается только для столбцов, вершина которых после сдвига
+  оказалась пустой (дыры под удаленной строкой открылись).
+*/
+int bbProfileClearRows(BoardProfile_t *profile, const BitBoard_t *board,
+                       const BoardRowSet_t *cleared) {
+  int count = 0;
+
+  if (profile && board && cleared) {
+    for (int w = 0; w < BB_ROWSET_WORDS; w++)
+      count += bbBitCount(cleared->words[w]);
+    if (count)
+      bbCompactRows(profile->rowFill, sizeof(profile->rowFill[0]), cleared);
+    for (int c = 0; c < GAME_BOARD_WIDTH && count; c++) {
+      int height = profile->heights[c] - count;
+      while (height > 0 &&
+             !(BB_ROW_CELLS(board, GAME_BOARD_HEIGHT - height) & (1u << c))) {
+        height--;
+        profile->holes[c]--;
+      }
+      profile->heights[c] = (int8_t)height;
+    }
+  }
+
+  return count;
+}
+
+/*!
+  \ingroup Profile_operations Функции профиля поверхности поля
+  \brief Функция поиска строки, на которой упавшая фигура ляжет на опору.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] profile Указатель на профиль поверхности поля board.
+  \param [in] mask Массив масок строк фигуры в локальных координатах.
+  \param [in] nrows Количество строк в массиве mask.
+  \param [in] row Смещение верхней строки фигуры относительно поля.
+  \param [in] col Смещение левого столбца фигуры относительно поля.
+  \return Наибольшее смещение фигуры по вертикали, достижимое падением из
+  строки row (row, если фигура уже лежит на опоре или пересекает поле).
+
+  Если каждая ячейка фигуры находится выше вершины своего столбца, путь до
+  вершины свободен, и расстояние падения равно наименьшему по ячейкам
+  расстоянию до вершины столбца: результат вычисляется по профилю за один
+  проход по ячейкам фигуры. Фигура, задвинутая под навес, опускается по маскам
+  строк поля.
+*/
+int bbDropRow(const BitBoard_t *board, const BoardProfile_t *profile,
+              const bbrow_t *mask, int nrows, int row, int col) {
+  int drop = GAME_BOARD_HEIGHT, surface = 1;
+  int fits = board && profile && mask;
+
+  for (int i = 0; i < nrows && fits && surface; i++) {
+    bbrow_t placed = 0;
+    if (!mask[i]) continue;
+    fits = bbPlaceRow(mask[i], col, &placed);
+    for (int c = 0; placed && surface; c++, placed >>= 1) {
+      if (placed & 1u) {
+        int gap = GAME_BOARD_HEIGHT - profile->heights[c] - 1 - (row + i);
+        if (gap < 0)
+          surface = 0;
+        else if (gap < drop)
+          drop = gap;
+      }
+    }
+  }
+  if (fits && surface) {
+    row += drop;
+  } else if (fits && !bbCollides(board, mask, nrows, row, col)) {
+    while (!bbCollides(board, mask, nrows, row + 1, col)) row++;
+  }
+
+  return row;
+}
@@ -0,0 +1,199 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл битового представления игрового поля.
+
+  Файл содержит описание структуры BitBoard_t, в которой каждая строка игрового
+  поля хранится в виде битовой маски занятых ячеек, и структуры BoardColors_t,
+  в которой отдельно в упакованном виде хранятся цвета ячеек (цветовая
+  плоскость). Проверки коллизий, фиксации фигуры и заполненности строки
+  выполняются операциями AND/OR/сравнения над строкой маски целиком, цветовая
+  плоскость используется только для отрисовки.
+
+  Маски строк хранятся в рамке из постоянно занятых сторожевых ячеек: слева и
+  справа от поля расположены стенки, снизу - строки пола, сверху - строки, в
+  которых заняты только стенки. Поэтому выход фигуры за границы поля
+  обнаруживается той же операцией AND, что и пересечение с занятыми ячейками.
+*/
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+#include "gamepref.h"
+
+/*!
+  \brief Тип битовой маски строки игрового поля.
+
+  В масках фигур и в значениях BB_ROW_CELLS() бит с номером c соответствует
+  столбцу c (0 - крайний левый). В хранимых строках BitBoard_t::rows столбцу
+  c соответствует бит c + BB_PAD, остальные биты - стенки.
+*/
+typedef uint16_t bbrow_t;
+
+/*!
+  \brief Тип строки цветовой плоскости игрового поля.
+
+  Каждой ячейке строки отводится BB_COLOR_BITS бит, ячейке в столбце c
+  соответствуют биты [c * BB_COLOR_BITS, (c + 1) * BB_COLOR_BITS).
+*/
+typedef uint32_t bbcolor_t;
+
+/*!
+  \brief Количество бит, отводимых под цвет одной ячейки.
+*/
+#define BB_COLOR_BITS 3
+
+/*!
+  \brief Маска значения цвета одной ячейки.
+*/
+#define BB_COLOR_MASK ((1u << BB_COLOR_BITS) - 1u)
+
+/*!
+  \brief Значение занятой ячейки, цвет которой неизвестен.
+
+  Используется при выгрузке поля без цветовой плоскости и для ячеек, цвет
+  которых не записан в цветовую плоскость (например, после восстановления
+  снимка, в который цветовая плоскость не входит).
+*/
+#define BB_DEFAULT_COLOR 1
+
+/*!
+  \brief Маска полностью заполненной строки игрового поля.
+*/
+#define BB_FULL_ROW ((bbrow_t)((1u << GAME_BOARD_WIDTH) - 1u))
+
+/*!
+  \brief Толщина сторожевой рамки битового игрового поля.
+
+  Количество сторожевых столбцов слева и сторожевых строк сверху и снизу
+  поля. Значение равно наибольшему выходу ячейки фигуры за границу поля
+  (TET_SIDE_MAX - 1), поэтому маска строки фигуры, хотя бы одна ячейка
+  которой находится на поле или в рамке, целиком попадает в хранимую строку.
+*/
+#define BB_PAD 3
+
+/*!
+  \brief Наибольший сдвиг маски строки фигуры внутри хранимой строки.
+*/
+#define BB_SHIFT_MAX (16 - (BB_PAD + 1))
+
+/*!
+  \brief Количество хранимых строк битового игрового поля.
+*/
+#define BB_ROWS (GAME_BOARD_HEIGHT + 2 * BB_PAD)
+
+/*!
+  \brief Маска стенок хранимой строки: все биты, кроме ячеек поля.
+*/
+#define BB_WALLS ((bbrow_t) ~(BB_FULL_ROW << BB_PAD))
+
+/*!
+  \brief Хранимая строка, занятая полностью: заполненная строка поля и
+  строка пола.
+*/
+#define BB_SOLID_ROW ((bbrow_t)0xFFFFu)
+
+/*!
+  \brief Маска занятых ячеек строки row игрового поля (бит c - столбец c).
+*/
+#define BB_ROW_CELLS(board, row) \
+  ((bbrow_t)(((board)->rows[(row) + BB_PAD] >> BB_PAD) & BB_FULL_ROW))
+
+/*!
+  \brief Количество 64-битных слов множества строк игрового поля.
+*/
+#define BB_ROWSET_WORDS ((GAME_BOARD_HEIGHT + 63) / 64)
+
+_Static_assert(GAME_BOARD_WIDTH + 2 * BB_PAD <= 16,
+               "bbrow_t не вмещает строку игрового поля со стенками");
+_Static_assert(GAME_BOARD_HEIGHT <= INT8_MAX,
+               "профиль поверхности не вмещает высоту игрового поля");
+_Static_assert(GAME_BOARD_WIDTH * BB_COLOR_BITS <= 32,
+               "bbcolor_t не вмещает цветовую строку игрового поля");
+
+/*!
+  \brief Структура битового представления игрового поля.
+
+  Структура не содержит указателей и может копироваться присваиванием.
+  Занятость ячеек определяется только масками строк, цвета ячеек хранятся
+  в сопровождающей структуре BoardColors_t.
+*/
+typedef struct BitBoard_t {
+  bbrow_t rows[BB_ROWS];  ///< Маски занятых ячеек по строкам со сторожевой
+                          ///< рамкой: строка row поля хранится в rows[row +
+                          ///< BB_PAD].
+} BitBoard_t;
+
+/*!
+  \brief Структура цветовой плоскости игрового поля.
+
+  Цвет ячейки учитывается, только если ячейка занята в маске BitBoard_t,
+  поэтому цвета освобожденных ячеек не требуется очищать.
+*/
+typedef struct BoardColors_t {
+  bbcolor_t rows[GAME_BOARD_HEIGHT];  ///< Упакованные цвета ячеек по строкам.
+} BoardColors_t;
+
+/*!
+  \brief Структура множества строк игрового поля.
+
+  Строке row соответствует бит row % 64 слова words[row / 64]. Размер
+  множества определяется высотой поля, поэтому множество описывает строки
+  поля любой высоты.
+*/
+typedef struct BoardRowSet_t {
+  uint64_t words[BB_ROWSET_WORDS];  ///< Биты строк.
+} BoardRowSet_t;
+
+/*!
+  \brief Структура профиля поверхности игрового поля.
+
+  Профиль не хранится в BitBoard_t, а сопровождает его: функции
+  bbProfileLock() и bbProfileClearRows() обновляют профиль после фиксации
+  фигуры и удаления строк без обхода всего поля, bbProfileBuild() строит его
+  заново. Высота столбца - количество строк от дна поля до верхней занятой
+  ячейки столбца включительно, дыра - пустая ячейка ниже верхней занятой.
+*/
+typedef struct BoardProfile_t {
+  int8_t heights[GAME_BOARD_WIDTH];  ///< Высоты столбцов.
+  int8_t holes[GAME_BOARD_WIDTH];  ///< Количество дыр в столбцах.
+  int8_t rowFill[GAME_BOARD_HEIGHT];  ///< Количество занятых ячеек строк.
+} BoardProfile_t;
+
+/*!
+  \defgroup Bitboard_operations Функции битового игрового поля
+  \brief Функции чтения, изменения и проверки битового игрового поля.
+*/
+void bbClear(BitBoard_t *board, BoardColors_t *colors);
+int bbGetCell(const BitBoard_t *board, const BoardColors_t *colors, int row,
+              int col);
+int bbSetCell(BitBoard_t *board, BoardColors_t *colors, int row, int col,
+              int val);
+int bbCollides(const BitBoard_t *board, const bbrow_t *mask, int nrows,
+               int row, int col);
+int bbLock(BitBoard_t *board, BoardColors_t *colors, const bbrow_t *mask,
+           int nrows, int row, int col, int val);
+int bbIsRowFull(const BitBoard_t *board, int row);
+int bbFindFullRows(const BitBoard_t *board, BoardRowSet_t *full);
+int bbClearFullRows(BitBoard_t *board, BoardColors_t *colors,
+                    BoardRowSet_t *cleared);
+void bbExportField(const BitBoard_t *board, const BoardColors_t *colors,
+                   int **field);
+
+/*!
+  \defgroup Profile_operations Функции профиля поверхности поля
+  \brief Функции построения и пошагового обновления профиля поверхности.
+*/
+void bbProfileBuild(BoardProfile_t *profile, const BitBoard_t *board);
+void bbProfileLock(BoardProfile_t *profile, const bbrow_t *mask, int nrows,
+                   int row, int col);
+int bbProfileClearRows(BoardProfile_t *profile, const BitBoard_t *board,
+                       const BoardRowSet_t *cleared);
+int bbDropRow(const BitBoard_t *board, const BoardProfile_t *profile,
+              const bbrow_t *mask, int nrows, int row, int col);
+
+#endif  // BITBOARD_H
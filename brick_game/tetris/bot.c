@@ -0,0 +1,148 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации простого игрового бота.
+*/
+
+#include "bot.h"
+
+/*!
+  \brief Весовые коэффициенты оценки игрового поля (в сотых долях).
+*/
+#define BOT_WEIGHT_HEIGHT (-51)
+#define BOT_WEIGHT_LINES 76
+#define BOT_WEIGHT_HOLES (-36)
+#define BOT_WEIGHT_BUMPINESS (-18)
+
+/*!
+  \ingroup Bot_player Функции игрового бота
+  \brief Функция сброса плана бота.
+  \param [out] plan Указатель на структуру BotPlan_t.
+*/
+void botReset(BotPlan_t *plan) {
+  if (plan) {
+    plan->pieces = -1;
+    plan->valid = 0;
+    plan->targetCol = 0;
+    plan->targetOrientation = ToTop;
+  }
+}
+
+/*!
+  \ingroup Bot_player Функции игрового бота
+  \brief Функция оценки игрового поля.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \return Оценка поля: чем больше значение, тем лучше поле.
+
+  Профиль поверхности строится по полю, после чего поле оценивается функцией
+  botEvaluateProfile().
+*/
+int botEvaluate(const BitBoard_t *board) {
+  BoardProfile_t profile;
+
+  bbProfileBuild(&profile, board);
+
+  return botEvaluateProfile(&profile);
+}
+
+/*!
+  \ingroup Bot_player Функции игрового бота
+  \brief Функция оценки игрового поля по профилю поверхности.
+  \param [in] profile Указатель на структуру BoardProfile_t.
+  \return Оценка поля: чем больше значение, тем лучше поле.
+
+  Учитываются суммарная высота столбцов, количество закрытых пустых ячеек и
+  неровность поверхности. Оценка выполняется за один проход по столбцам.
+*/
+int botEvaluateProfile(const BoardProfile_t *profile) {
+  int aggregate = 0, holes = 0, bumpiness = 0;
+
+  for (int col = 0; col < GAME_BOARD_WIDTH; col++) {
+    aggregate += profile->heights[col];
+    holes += profile->holes[col];
+    if (col) {
+      int diff = profile->heights[col] - profile->heights[col - 1];
+      bumpiness += diff < 0 ? -diff : diff;
+    }
+  }
+
+  return BOT_WEIGHT_HEIGHT * aggregate + BOT_WEIGHT_HOLES * holes +
+         BOT_WEIGHT_BUMPINESS * bumpiness;
+}
+
+/*!
+  \brief Функция построения плана размещения текущей фигуры.
+
+  Для каждой ориентации и каждого столбца фигура опускается до упора на копии
+  поля, профиль поверхности копии обновляется по ячейкам фигуры, после чего
+  поле оценивается функцией botEvaluateProfile().
+*/
+static void botPlan(const Game_t *game, BotPlan_t *plan) {
+  int best = 0;
+
+  plan->valid = 0;
+  for (int o = 0; o < TET_ORIENT_COUNT; o++) {
+    for (int col = -TET_SIDE_MAX; col < GAME_BOARD_WIDTH; col++) {
+      TetraminoState_t state = *game->curTetState;
+      BitBoard_t board = game->core.board;
+      BoardProfile_t profile = game->core.profile;
+      BoardRowSet_t cleared;
+      const TetraminoShape_t *shape =
+          &tetraminoShapes[state.tetraminoIndex][o];
+      int score = 0, lines = 0;
+
+      state.orientation = o;
+      state.offsetCol = col;
+      if (checkBoardCollision(&board, &state)) continue;
+      while (!bbCollides(&board, shape->rows, TET_SIDE_MAX,
+                         state.offsetRow + 1, col))
+        state.offsetRow++;
+      if (!bbLock(&board, NULL, shape->rows, TET_SIDE_MAX, state.offsetRow,
+                  col, (int)state.tetraminoIndex + 1))
+        bbProfileLock(&profile, shape->rows, TET_SIDE_MAX, state.offsetRow,
+                      col);
+      lines = bbClearFullRows(&board, NULL, &cleared);
+      bbProfileClearRows(&profile, &board, &cleared);
+      score = botEvaluateProfile(&profile) + BOT_WEIGHT_LINES * lines;
+      if (!plan->valid || score > best) {
+        best = score;
+        plan->valid = 1;
+        plan->targetCol = col;
+        plan->targetOrientation = o;
+      }
+    }
+  }
+  plan->pieces = game->core.pieces;
+}
+
+/*!
+  \ingroup Bot_player Функции игрового бота
+  \brief Функция выбора следующего действия пользователя.
+  \param [in] game Указатель на структуру Game_t.
+  \param [in,out] plan Указатель на план бота, сохраняемый между вызовами.
+  \return Действие пользователя для передачи в tetris_step().
+
+  План строится один раз для каждой новой фигуры. Затем бот поворачивает
+  фигуру, смещает ее к целевому столбцу и ускоряет падение.
+*/
+UserAction_t botChooseAction(const Game_t *game, BotPlan_t *plan) {
+  UserAction_t action = None;
+
+  if (game && plan && game->curTetState && game->core.state == fsm_move) {
+    if (plan->pieces != game->core.pieces) botPlan(game, plan);
+    if (!plan->valid)
+      action = Down;
+    else if (game->curTetState->orientation != plan->targetOrientation)
+      action = Action;
+    else if (game->curTetState->offsetCol < plan->targetCol)
+      action = Right;
+    else if (game->curTetState->offsetCol > plan->targetCol)
+      action = Left;
+    else
+      action = Down;
+  }
+
+  return action;
+}
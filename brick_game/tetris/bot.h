@@ -0,0 +1,37 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл простого игрового бота.
+
+  Бот перебирает все ориентации и столбцы для текущей фигуры, оценивает
+  получившееся игровое поле и выдает действия пользователя, приводящие фигуру в
+  выбранное положение. Бот используется для пакетного моделирования игр.
+*/
+
+#ifndef BOT_H
+#define BOT_H
+
+#include "tetris.h"
+
+/*!
+  \brief Структура плана размещения текущей фигуры.
+*/
+typedef struct BotPlan_t {
+  int pieces;  ///< Значение GameCore_t::pieces, для которого построен план.
+  int valid;  ///< Признак наличия плана.
+  int targetCol;  ///< Целевое смещение фигуры по горизонтали.
+  int targetOrientation;  ///< Целевая ориентация фигуры.
+} BotPlan_t;
+
+/*!
+  \defgroup Bot_player Функции игрового бота
+  \brief Функции выбора действий пользователя ботом.
+*/
+void botReset(BotPlan_t *plan);
+int botEvaluate(const BitBoard_t *board);
+int botEvaluateProfile(const BoardProfile_t *profile);
+UserAction_t botChooseAction(const Game_t *game, BotPlan_t *plan);
+
+#endif  // BOT_H
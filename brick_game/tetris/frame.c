@@ -0,0 +1,128 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации функций снимков кадра и тройного буфера кадров.
+*/
+
+#include "frame.h"
+
+#include <string.h>
+
+/*!
+  \ingroup Frame_operations Функции снимков кадра
+  \brief Функция снятия кадра с экземпляра игры.
+  \param [in] game Указатель на структуру Game_t.
+  \param [out] frame Указатель на кадр, связанный функцией frameBufferInit().
+  \return 0 - успешное выполнение, 1 - при отсутствии указателей.
+*/
+int frameCapture(const Game_t *game, GameFrame_t *frame) {
+  int err = 1;
+
+  if (game && frame) {
+    frame->state = game->core.state;
+    frame->tick = game->core.tick;
+    frame->hasInfo = (game->gameInfo != NULL);
+    exportGameField(game, frame->fieldRows, frame->nextRows);
+    exportGhost(game, frame->fieldRows);
+    frame->profile = game->core.profile;
+    frame->clearedRows = game->core.clearedRows;
+    if (game->gameInfo) {
+      frame->info.score = game->core.score;
+      frame->info.high_score = game->core.highScore;
+      frame->info.level = game->core.level;
+      frame->info.speed = game->core.speed;
+      frame->info.pause = game->core.pause;
+    } else {
+      frame->info.score = 0;
+      frame->info.high_score = 0;
+      frame->info.level = 0;
+      frame->info.speed = 0;
+      frame->info.pause = 0;
+    }
+    err = 0;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Frame_operations Функции снимков кадра
+  \brief Функция инициализации тройного буфера кадров.
+  \param [out] buffer Указатель на структуру FrameBuffer_t.
+
+  Кадры очищаются, их указатели связываются с собственными массивами.
+  Буфер нельзя перемещать в памяти после инициализации.
+*/
+void frameBufferInit(FrameBuffer_t *buffer) {
+  if (buffer) {
+    memset(buffer, 0, sizeof(*buffer));
+    for (int f = 0; f < 3; f++) {
+      GameFrame_t *frame = &buffer->frames[f];
+      for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+        frame->fieldRows[i] = frame->field[i];
+      for (int i = 0; i < TET_SIDE_MAX; i++) frame->nextRows[i] = frame->next[i];
+      frame->info.field = frame->fieldRows;
+      frame->info.next = frame->nextRows;
+      frame->state = fsm_none;
+    }
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1u);
+    buffer->front = 2;
+  }
+}
+
+/*!
+  \ingroup Frame_operations Функции снимков кадра
+  \brief Функция получения кадра, заполняемого писателем.
+  \param [in] buffer Указатель на структуру FrameBuffer_t.
+  \return Указатель на задний кадр. Вызывается только потоком писателя.
+*/
+GameFrame_t *frameBack(FrameBuffer_t *buffer) {
+  return buffer ? &buffer->frames[buffer->back] : NULL;
+}
+
+/*!
+  \ingroup Frame_operations Функции снимков кадра
+  \brief Функция публикации заполненного заднего кадра.
+  \param [in,out] buffer Указатель на структуру FrameBuffer_t.
+
+  Задний кадр становится промежуточным, прежний промежуточный кадр - задним.
+  Если читатель не забрал предыдущий кадр, он будет перезаписан следующим.
+*/
+void framePublish(FrameBuffer_t *buffer) {
+  if (buffer) {
+    unsigned prev = atomic_exchange_explicit(
+        &buffer->middle, buffer->back | FRAME_FRESH, memory_order_acq_rel);
+    buffer->back = prev & FRAME_INDEX_MASK;
+  }
+}
+
+/*!
+  \ingroup Frame_operations Функции снимков кадра
+  \brief Функция получения самого нового опубликованного кадра.
+  \param [in,out] buffer Указатель на структуру FrameBuffer_t.
+  \param [out] fresh Признак того, что кадр опубликован после предыдущего
+  вызова функции (может быть NULL).
+  \return Указатель на передний кадр, который остается неизменным до
+  следующего вызова функции. Вызывается только потоком читателя.
+*/
+const GameFrame_t *frameAcquire(FrameBuffer_t *buffer, bool *fresh) {
+  const GameFrame_t *frame = NULL;
+  bool isFresh = false;
+
+  if (buffer) {
+    if (atomic_load_explicit(&buffer->middle, memory_order_relaxed) &
+        FRAME_FRESH) {
+      unsigned prev = atomic_exchange_explicit(&buffer->middle, buffer->front,
+                                               memory_order_acq_rel);
+      buffer->front = prev & FRAME_INDEX_MASK;
+      isFresh = true;
+    }
+    frame = &buffer->frames[buffer->front];
+  }
+  if (fresh) *fresh = isFresh;
+
+  return frame;
+}
@@ -0,0 +1,82 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл снимков кадра и тройного буфера кадров.
+
+  Снимок кадра GameFrame_t содержит все данные, необходимые для отрисовки
+  состояния игры: поле с текущей фигурой, следующую фигуру, очки и состояние
+  конечного автомата. Снимок не ссылается на память игры, поэтому поток логики
+  может продолжать изменять игру, пока другой поток отрисовывает кадр.
+
+  Кадры передаются между потоками через тройной буфер без блокировок: писатель
+  заполняет свой задний кадр и обменивает его с промежуточным, читатель
+  забирает промежуточный кадр, если он новее переднего. Обмен выполняется
+  одной атомарной операцией, поэтому ни один из потоков не ожидает другого, а
+  читатель всегда получает самый новый целостный кадр.
+*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdatomic.h>
+
+#include "tetris.h"
+
+/*!
+  \brief Признак того, что промежуточный кадр еще не забран читателем.
+*/
+#define FRAME_FRESH 0x4u
+
+/*!
+  \brief Маска индекса кадра в значении промежуточного кадра.
+*/
+#define FRAME_INDEX_MASK 0x3u
+
+/*!
+  \brief Структура снимка кадра.
+
+  Указатели info.field и info.next ссылаются на массивы этого же кадра и
+  связываются функцией frameBufferInit(), поэтому кадр можно передавать в
+  функции отрисовки, принимающие GameInfo_t. Поле кадра содержит проекцию
+  текущей фигуры на опору (ячейки TET_GHOST_CELL).
+*/
+typedef struct GameFrame_t {
+  _Alignas(GAME_ARENA_ALIGN) int field[GAME_BOARD_HEIGHT]
+                                      [GAME_BOARD_WIDTH];  ///< Ячейки поля.
+  int next[TET_SIDE_MAX][TET_SIDE_MAX];  ///< Ячейки следующей фигуры.
+  int* fieldRows[GAME_BOARD_HEIGHT];  ///< Строки массива field.
+  int* nextRows[TET_SIDE_MAX];  ///< Строки массива next.
+  GameInfo_t info;  ///< Состояние игры для функций отрисовки.
+  BoardProfile_t profile;  ///< Профиль поверхности поля (только для чтения).
+  BoardRowSet_t clearedRows;  ///< Строки, удаленные при последней фиксации.
+  fsm_state_t state;  ///< Состояние конечного автомата игры.
+  bool hasInfo;  ///< Признак наличия начатой игры (иначе - главное меню).
+  uint64_t tick;  ///< Логический такт, на котором снят кадр.
+} GameFrame_t;
+
+/*!
+  \brief Структура тройного буфера кадров.
+
+  Поле back принадлежит писателю, поле front - читателю, промежуточный кадр
+  middle изменяется только атомарным обменом.
+*/
+typedef struct FrameBuffer_t {
+  GameFrame_t frames[3];  ///< Кадры буфера.
+  _Atomic unsigned middle;  ///< Индекс промежуточного кадра и FRAME_FRESH.
+  unsigned back;  ///< Индекс кадра, заполняемого писателем.
+  unsigned front;  ///< Индекс кадра, отрисовываемого читателем.
+} FrameBuffer_t;
+
+/*!
+  \defgroup Frame_operations Функции снимков кадра
+  \brief Функции снятия кадров и передачи их между потоками.
+*/
+int frameCapture(const Game_t *game, GameFrame_t *frame);
+void frameBufferInit(FrameBuffer_t *buffer);
+GameFrame_t *frameBack(FrameBuffer_t *buffer);
+void framePublish(FrameBuffer_t *buffer);
+const GameFrame_t *frameAcquire(FrameBuffer_t *buffer, bool *fresh);
+
+#endif  // FRAME_H
@@ -14,13 +14,29 @@
 #ifndef GAMEPREF_H
 #define GAMEPREF_H
 
+/*!
+  \brief Макрос размерности массива фигур (тетрамино)
+*/
+#define TET_COUNT 7
+
+/*!
+    \brief Зерно генератора последовательности фигур по умолчанию.
+
+    Используется для экземпляров игры, которым зерно не было задано явно
+   функцией seedGame().
+*/
+#define GAME_DEFAULT_SEED 21
+
 /*!
     \brief Высота доступного игрового поля.
 
     Макрос определяет высоту доступного игрового поля в игре. По умолчанию
-   определено значение в 20 ячеек (условие технического задания).
+   определено значение в 20 ячеек (условие технического задания), для
+   нестандартных полей значение задается при сборке (-DGAME_BOARD_HEIGHT=N).
 */
+#ifndef GAME_BOARD_HEIGHT
 #define GAME_BOARD_HEIGHT 20
+#endif
 
 /*!
     \brief Ширина доступного игрового .
@@ -50,13 +66,78 @@
     Задержка выполнения цикла (пока так, дальше определимся по мере реализации.)
 */
 #define GAME_SPEED_DEFAULT 1
-#define GAME_SPEED_MAX 10
+#define GAME_SPEED_MAX 20
 #define GAME_SPEED_DELAY 10
 #define GAME_SPEED_MAX_DELAY 1000
 
 /*!
-    Модификатор задержки для изменения скорости в игре
+    \brief Одна ячейка в единицах гравитации (фиксированная точка Q16).
+
+    Гравитация задается количеством ячеек за логический такт с 16 дробными
+   битами, поэтому поддерживаются как доли ячейки, так и несколько ячеек за
+   такт.
+*/
+#define GAME_GRAVITY_ONE 65536
+
+/*!
+    \brief Гравитация в ячейках за такт по времени смещения на одну ячейку.
+
+    Вычисляется при компиляции из времени в микросекундах с округлением вверх,
+   поэтому интервал смещения в тактах не превышает заданного времени.
+*/
+#define GAME_GRAVITY_US(us)                                          \
+  ((int32_t)(((long long)GAME_SPEED_DELAY * 1000 * GAME_GRAVITY_ONE + \
+              (us) - 1) /                                            \
+             (us)))
+
+/*!
+    \brief Гравитация 20G: фигура за один такт опускается до препятствия.
+*/
+#define GAME_GRAVITY_20G (GAME_BOARD_HEIGHT * GAME_GRAVITY_ONE)
+
+/*!
+    \brief Количество очков, необходимое для перехода на следующий уровень.
+*/
+#define GAME_LEVEL_SCORE 600
+
+/*!
+    \brief Количество логических тактов в секунде.
+
+    Один логический такт игрового движка соответствует GAME_SPEED_DELAY
+   миллисекундам реального времени.
+*/
+#define GAME_TICKS_PER_SECOND (GAME_SPEED_MAX_DELAY / GAME_SPEED_DELAY)
+
+/*!
+    \brief Задержка автоповтора (DAS) по умолчанию в логических тактах.
+
+    Количество тактов удержания клавиши смещения до первого автоповтора
+   (170 мс).
+*/
+#define GAME_DAS_TICKS 17
+
+/*!
+    \brief Интервал автоповтора (ARR) по умолчанию в логических тактах.
+
+    Количество тактов между повторными смещениями удерживаемой фигуры (50 мс).
+   Значение 0 означает мгновенное смещение до препятствия.
+*/
+#define GAME_ARR_TICKS 5
+
+/*!
+    \brief Задержка фиксации фигуры по умолчанию в логических тактах.
+
+    Количество тактов, которое фигура, лежащая на опоре, остается подвижной
+   до присоединения к игровому полю (500 мс).
+*/
+#define GAME_LOCK_TICKS 50
+
+/*!
+    \brief Количество перезапусков задержки фиксации по умолчанию.
+
+    Смещение или поворот лежащей фигуры перезапускает задержку фиксации не
+   более указанного количества раз, пока фигура не опустится ниже.
 */
-#define GAME_SPEED_DELAY_MODIFIER 0.9
+#define GAME_LOCK_RESETS 15
 
 #endif
\ No newline at end of file
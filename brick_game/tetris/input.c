@@ -0,0 +1,68 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации функций очереди событий ввода.
+*/
+
+#include "input.h"
+
+/*!
+  \ingroup Input_queue_operations Функции очереди событий ввода
+  \brief Функция инициализации пустой очереди событий ввода.
+  \param [out] queue Указатель на структуру InputQueue_t.
+*/
+void inputQueueInit(InputQueue_t *queue) {
+  if (queue) {
+    atomic_init(&queue->head, 0u);
+    atomic_init(&queue->tail, 0u);
+  }
+}
+
+/*!
+  \ingroup Input_queue_operations Функции очереди событий ввода
+  \brief Функция добавления события в очередь. Вызывается только писателем.
+  \param [in,out] queue Указатель на структуру InputQueue_t.
+  \param [in] event Указатель на добавляемое событие.
+  \return 0 - событие добавлено, 1 - очередь заполнена или нет указателей.
+*/
+int inputQueuePush(InputQueue_t *queue, const InputEvent_t *event) {
+  int err = 1;
+
+  if (queue && event) {
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head < INPUT_QUEUE_SIZE) {
+      queue->events[tail & (INPUT_QUEUE_SIZE - 1)] = *event;
+      atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+      err = 0;
+    }
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Input_queue_operations Функции очереди событий ввода
+  \brief Функция извлечения самого раннего события. Вызывается только
+  читателем.
+  \param [in,out] queue Указатель на структуру InputQueue_t.
+  \param [out] event Указатель на структуру для извлеченного события.
+  \return 0 - событие извлечено, 1 - очередь пуста или нет указателей.
+*/
+int inputQueuePop(InputQueue_t *queue, InputEvent_t *event) {
+  int err = 1;
+
+  if (queue && event) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head != tail) {
+      *event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+      atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+      err = 0;
+    }
+  }
+
+  return err;
+}
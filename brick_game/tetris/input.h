@@ -0,0 +1,62 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл очереди событий ввода.
+
+  Очередь InputQueue_t - кольцевой буфер без блокировок для одного писателя
+  (поток ввода) и одного читателя (поток логики). Каждое событие содержит
+  момент времени, действие пользователя и признак нажатия или отпускания
+  клавиши, поэтому читатель может применить событие на том логическом такте,
+  на котором клавиша была нажата, а не на том, на котором событие прочитано.
+*/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdatomic.h>
+
+#include "tetris.h"
+
+/*!
+  \brief Количество событий в очереди (степень двойки).
+*/
+#define INPUT_QUEUE_SIZE 256
+
+_Static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0,
+               "размер очереди ввода должен быть степенью двойки");
+
+/*!
+  \brief Структура события ввода.
+*/
+typedef struct InputEvent_t {
+  uint64_t time;  ///< Момент события в наносекундах (CLOCK_MONOTONIC).
+  uint8_t action;  ///< Действие пользователя (UserAction_t).
+  uint8_t pressed;  ///< 1 - клавиша нажата, 0 - отпущена.
+  uint8_t hold;  ///< 1 - нажатие удерживается до события отпускания (признак
+                 ///< удержания userInputCtx()).
+} InputEvent_t;
+
+/*!
+  \brief Структура очереди событий ввода.
+
+  Индексы писателя и читателя расположены в разных строках кэша, чтобы потоки
+  не вытесняли строки друг друга при каждом событии.
+*/
+typedef struct InputQueue_t {
+  _Alignas(GAME_ARENA_ALIGN) _Atomic uint32_t head;  ///< Индекс читателя.
+  _Alignas(GAME_ARENA_ALIGN) _Atomic uint32_t tail;  ///< Индекс писателя.
+  _Alignas(GAME_ARENA_ALIGN) InputEvent_t
+      events[INPUT_QUEUE_SIZE];  ///< Кольцевой буфер событий.
+} InputQueue_t;
+
+/*!
+  \defgroup Input_queue_operations Функции очереди событий ввода
+  \brief Функции передачи событий ввода между потоками.
+*/
+void inputQueueInit(InputQueue_t *queue);
+int inputQueuePush(InputQueue_t *queue, const InputEvent_t *event);
+int inputQueuePop(InputQueue_t *queue, InputEvent_t *event);
+
+#endif  // INPUT_H
@@ -0,0 +1,282 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации записи и воспроизведения повторов игры.
+*/
+
+#include "replay.h"
+
+#include <limits.h>
+#include <string.h>
+
+/*!
+  \brief Сигнатура файла повтора.
+*/
+static const uint8_t replayMagic[4] = {'S', '2', '1', 'R'};
+
+/*!
+  \brief Размер заголовка повтора в файле в байтах.
+*/
+#define REPLAY_HEADER_SIZE 26
+
+/*!
+  \brief Количество бит события, занятых действием и признаком удержания.
+*/
+#define REPLAY_ACTION_BITS 5
+
+static void putLE(uint8_t *buf, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) buf[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t getLE(const uint8_t *buf, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; i++) value |= (uint64_t)buf[i] << (8 * i);
+  return value;
+}
+
+static void replayFlush(ReplayWriter_t *writer) {
+  if (writer->len) fwrite(writer->buf, 1, writer->len, writer->file);
+  writer->len = 0;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция начала записи повтора игры.
+  \param [out] writer Указатель на структуру записи повтора.
+  \param [in] path Путь к файлу повтора.
+  \param [in,out] game Указатель на структуру Game_t.
+  \return 0 - успешное выполнение, 1 - ошибка открытия файла.
+
+  Функция подключает запись к экземпляру игры: все действия, переданные в
+  userInputCtx(), записываются в повтор. Генератор фигур игры повторно
+  инициализируется зерном GameCore_t::seed, поэтому запись необходимо начинать
+  до начала игры (до действия Start).
+*/
+int replayOpenWrite(ReplayWriter_t *writer, const char *path, Game_t *game) {
+  int err = 1;
+
+  if (writer && path && game && (writer->file = fopen(path, "wb")) != NULL) {
+    seedGame(game, game->core.seed,
+             (tetSequencePolicy_t)game->core.sequence.policy);
+    memcpy(writer->buf, replayMagic, sizeof(replayMagic));
+    writer->buf[4] = REPLAY_VERSION;
+    writer->buf[5] = game->core.sequence.policy;
+    writer->buf[6] = GAME_BOARD_WIDTH;
+    writer->buf[7] = GAME_BOARD_HEIGHT;
+    putLE(writer->buf + 8, GAME_SPEED_DELAY, 2);
+    putLE(writer->buf + 10, game->core.seed, 8);
+    putLE(writer->buf + 18, (uint64_t)game->core.dasTicks, 2);
+    putLE(writer->buf + 20, (uint64_t)game->core.arrTicks, 2);
+    putLE(writer->buf + 22, (uint64_t)game->core.lockTicks, 2);
+    putLE(writer->buf + 24, (uint64_t)game->core.lockResetMax, 2);
+    writer->len = REPLAY_HEADER_SIZE;
+    writer->lastTick = game->core.tick;
+    game->replay = writer;
+    err = 0;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция записи события повтора.
+  \param [in,out] writer Указатель на структуру записи повтора.
+  \param [in] tick Логический такт события.
+  \param [in] action Действие пользователя.
+  \param [in] hold Признак удержания.
+
+  Событие кодируется в буфер в памяти, файл записывается только при
+  заполнении буфера.
+*/
+void replayRecord(ReplayWriter_t *writer, uint64_t tick, UserAction_t action,
+                  bool hold) {
+  if (writer && writer->file) {
+    uint64_t value = ((tick - writer->lastTick) << REPLAY_ACTION_BITS) |
+                     ((uint64_t)(hold ? 1 : 0) << 4) | ((uint64_t)action & 15u);
+    if (writer->len + REPLAY_EVENT_MAX > REPLAY_BUFFER_SIZE)
+      replayFlush(writer);
+    while (value >= 0x80) {
+      writer->buf[writer->len++] = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+    writer->buf[writer->len++] = (uint8_t)value;
+    writer->lastTick = tick;
+  }
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция завершения записи повтора.
+  \param [in,out] writer Указатель на структуру записи повтора.
+  \param [in,out] game Указатель на структуру Game_t, к которой подключена
+  запись, или NULL.
+  \return 0 - успешное выполнение, 1 - ошибка записи файла.
+
+  В поток записывается завершающее событие с текущим тактом игры, запись
+  отключается от игры, файл закрывается.
+*/
+int replayCloseWrite(ReplayWriter_t *writer, Game_t *game) {
+  int err = 1;
+
+  if (writer && writer->file) {
+    replayRecord(writer, game ? game->core.tick : writer->lastTick, None,
+                 false);
+    replayFlush(writer);
+    err = ferror(writer->file) != 0;
+    if (fclose(writer->file)) err = 1;
+    writer->file = NULL;
+  }
+  if (game && game->replay == writer) game->replay = NULL;
+
+  return err;
+}
+
+static int replayReadByte(ReplayReader_t *reader, uint8_t *byte) {
+  int err = 0;
+
+  if (reader->pos >= reader->len) {
+    reader->len = fread(reader->buf, 1, REPLAY_BUFFER_SIZE, reader->file);
+    reader->pos = 0;
+  }
+  if (reader->pos < reader->len)
+    *byte = reader->buf[reader->pos++];
+  else
+    err = 1;
+
+  return err;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция открытия повтора для чтения.
+  \param [out] reader Указатель на структуру чтения повтора.
+  \param [in] path Путь к файлу повтора.
+  \return 0 - успешное выполнение, 1 - ошибка открытия файла или неверный
+  заголовок.
+*/
+int replayOpenRead(ReplayReader_t *reader, const char *path) {
+  int err = 1;
+
+  if (reader && path && (reader->file = fopen(path, "rb")) != NULL) {
+    uint8_t header[REPLAY_HEADER_SIZE];
+    reader->pos = reader->len = 0;
+    reader->tick = 0;
+    err = 0;
+    for (int i = 0; i < REPLAY_HEADER_SIZE && !err; i++)
+      err = replayReadByte(reader, &header[i]);
+    if (!err && (memcmp(header, replayMagic, sizeof(replayMagic)) ||
+                 header[4] != REPLAY_VERSION))
+      err = 1;
+    if (!err) {
+      reader->header.version = header[4];
+      reader->header.policy = header[5];
+      reader->header.width = header[6];
+      reader->header.height = header[7];
+      reader->header.tickMs = (uint16_t)getLE(header + 8, 2);
+      reader->header.seed = getLE(header + 10, 8);
+      reader->header.dasTicks = (uint16_t)getLE(header + 18, 2);
+      reader->header.arrTicks = (uint16_t)getLE(header + 20, 2);
+      reader->header.lockTicks = (uint16_t)getLE(header + 22, 2);
+      reader->header.lockResets = (uint16_t)getLE(header + 24, 2);
+    } else {
+      replayCloseRead(reader);
+    }
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция чтения следующего события повтора.
+  \param [in,out] reader Указатель на структуру чтения повтора.
+  \param [out] event Указатель на структуру события.
+  \return 0 - событие прочитано, 1 - поток закончился или поврежден.
+*/
+int replayReadEvent(ReplayReader_t *reader, ReplayEvent_t *event) {
+  int err = !reader || !reader->file || !event;
+  uint64_t value = 0;
+  uint8_t byte = 0x80;
+
+  for (int shift = 0; !err && (byte & 0x80); shift += 7) {
+    if (shift >= 64 || replayReadByte(reader, &byte))
+      err = 1;
+    else
+      value |= (uint64_t)(byte & 0x7F) << shift;
+  }
+  if (!err) {
+    reader->tick += value >> REPLAY_ACTION_BITS;
+    event->tick = reader->tick;
+    event->hold = (value >> 4) & 1u;
+    event->action = (UserAction_t)(value & 15u);
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция закрытия повтора.
+  \param [in,out] reader Указатель на структуру чтения повтора.
+*/
+void replayCloseRead(ReplayReader_t *reader) {
+  if (reader && reader->file) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция подготовки игры к воспроизведению повтора.
+  \param [in] reader Указатель на структуру чтения повтора.
+  \param [in,out] game Указатель на структуру Game_t, созданную функцией
+  createGameCtx() и еще не начатую.
+  \return 0 - успешное выполнение, 1 - повтор записан для другого размера поля
+  или с недопустимыми параметрами автоповтора и задержки фиксации.
+*/
+int replayPrepareGame(const ReplayReader_t *reader, Game_t *game) {
+  int err = !reader || !game || reader->header.width != GAME_BOARD_WIDTH ||
+            reader->header.height != GAME_BOARD_HEIGHT;
+
+  if (!err) {
+    seedGame(game, reader->header.seed,
+             (tetSequencePolicy_t)reader->header.policy);
+    err =
+        setAutoShift(game, reader->header.dasTicks, reader->header.arrTicks) ||
+        setLockDelay(game, reader->header.lockTicks, reader->header.lockResets);
+    game->replay = NULL;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функция воспроизведения повтора с максимальной скоростью.
+  \param [in,out] reader Указатель на структуру чтения повтора.
+  \param [in,out] game Указатель на структуру Game_t, созданную функцией
+  createGameCtx() и еще не начатую.
+  \return 0 - успешное выполнение, 1 - повтор несовместим с игрой.
+
+  Игра продвигается функцией tetris_step() до такта каждого события, после
+  чего действие передается в userInputCtx(). Терминал и реальное время не
+  используются.
+*/
+int replayPlay(ReplayReader_t *reader, Game_t *game) {
+  int err = replayPrepareGame(reader, game);
+  ReplayEvent_t event;
+
+  while (!err && !replayReadEvent(reader, &event)) {
+    while (event.tick > game->core.tick) {
+      uint64_t delta = event.tick - game->core.tick;
+      tetris_step(game, None, delta > INT_MAX ? INT_MAX : (int)delta);
+    }
+    if (event.action != None) userInputCtx(game, event.action, event.hold);
+  }
+
+  return err;
+}
@@ -0,0 +1,101 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл записи и воспроизведения повторов игры.
+
+  Повтор состоит из заголовка (сигнатура, версия, размеры поля, длительность
+  такта, политика и зерно генератора фигур, параметры автоповтора и задержки
+  фиксации) и потока событий. Каждое событие -
+  одно число в формате varint, содержащее приращение логических тактов с
+  предыдущего события, признак удержания и действие пользователя:
+  (delta << 5) | (hold << 4) | action. Событие с действием None завершает
+  поток и фиксирует последний такт игры. Запись событий выполняется в буфер в
+  памяти и не требует обращения к файлу на каждое действие.
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+
+#include "tetris.h"
+
+/*!
+  \brief Версия формата повтора.
+*/
+#define REPLAY_VERSION 1
+
+/*!
+  \brief Размер буфера записи и чтения повтора в байтах.
+*/
+#define REPLAY_BUFFER_SIZE 4096
+
+/*!
+  \brief Максимальная длина одного события в байтах.
+*/
+#define REPLAY_EVENT_MAX 10
+
+/*!
+  \brief Структура заголовка повтора.
+*/
+typedef struct ReplayHeader_t {
+  uint8_t version;  ///< Версия формата.
+  uint8_t policy;   ///< Политика последовательности фигур.
+  uint8_t width;    ///< Ширина игрового поля.
+  uint8_t height;   ///< Высота игрового поля.
+  uint16_t tickMs;  ///< Длительность логического такта в миллисекундах.
+  uint64_t seed;    ///< Зерно генератора фигур.
+  uint16_t dasTicks;  ///< Задержка автоповтора в тактах.
+  uint16_t arrTicks;  ///< Интервал автоповтора в тактах.
+  uint16_t lockTicks;  ///< Задержка фиксации фигуры в тактах.
+  uint16_t lockResets;  ///< Допустимое количество перезапусков задержки.
+} ReplayHeader_t;
+
+/*!
+  \brief Структура события повтора.
+*/
+typedef struct ReplayEvent_t {
+  uint64_t tick;  ///< Логический такт, на котором выполнено действие.
+  UserAction_t action;  ///< Действие пользователя.
+  bool hold;  ///< Признак удержания.
+} ReplayEvent_t;
+
+/*!
+  \brief Структура записи повтора.
+*/
+typedef struct ReplayWriter_t {
+  FILE *file;  ///< Файл повтора.
+  uint64_t lastTick;  ///< Такт последнего записанного события.
+  size_t len;  ///< Количество заполненных байт буфера.
+  uint8_t buf[REPLAY_BUFFER_SIZE];  ///< Буфер записи.
+} ReplayWriter_t;
+
+/*!
+  \brief Структура чтения повтора.
+*/
+typedef struct ReplayReader_t {
+  FILE *file;  ///< Файл повтора.
+  ReplayHeader_t header;  ///< Прочитанный заголовок.
+  uint64_t tick;  ///< Такт последнего прочитанного события.
+  size_t pos;  ///< Позиция чтения в буфере.
+  size_t len;  ///< Количество заполненных байт буфера.
+  uint8_t buf[REPLAY_BUFFER_SIZE];  ///< Буфер чтения.
+} ReplayReader_t;
+
+/*!
+  \defgroup Replay_operations Функции записи и воспроизведения повторов
+  \brief Функции записи действий пользователя и их воспроизведения.
+*/
+int replayOpenWrite(ReplayWriter_t *writer, const char *path, Game_t *game);
+void replayRecord(ReplayWriter_t *writer, uint64_t tick, UserAction_t action,
+                  bool hold);
+int replayCloseWrite(ReplayWriter_t *writer, Game_t *game);
+int replayOpenRead(ReplayReader_t *reader, const char *path);
+int replayReadEvent(ReplayReader_t *reader, ReplayEvent_t *event);
+void replayCloseRead(ReplayReader_t *reader);
+int replayPrepareGame(const ReplayReader_t *reader, Game_t *game);
+int replayPlay(ReplayReader_t *reader, Game_t *game);
+
+#endif  // REPLAY_H
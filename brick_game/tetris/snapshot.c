@@ -0,0 +1,58 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации функций снимков состояния игры.
+*/
+
+#include "snapshot.h"
+
+#include <string.h>
+
+/*!
+  \ingroup Snapshot_operations Функции снимков состояния игры
+  \brief Функция сохранения состояния игры в снимок.
+  \param [in] game Указатель на структуру Game_t.
+  \param [out] snapshot Указатель на структуру GameSnapshot_t.
+  \return 0 - успешное выполнение, 1 - при отсутствии указателей.
+
+  Цветовая плоскость поля и запись повтора, подключенная к игре, в снимок не
+  входят.
+*/
+int snapshotGame(const Game_t *game, GameSnapshot_t *snapshot) {
+  int err = 1;
+
+  if (game && snapshot) {
+    memcpy(snapshot, &game->core, sizeof(*snapshot));
+    err = 0;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Snapshot_operations Функции снимков состояния игры
+  \brief Функция восстановления состояния игры из снимка.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] snapshot Указатель на структуру GameSnapshot_t.
+  \return 0 - успешное выполнение, 1 - при отсутствии указателей.
+
+  Блок состояния копируется целиком, после чего указатели
+  gameInfo и curTetState связываются со структурами области памяти игры или
+  отключаются, если в снимке игра не начата. Цветовая плоскость поля и запись
+  повтора, подключенная к игре, не изменяются.
+*/
+int restoreGame(Game_t *game, const GameSnapshot_t *snapshot) {
+  int err = 1;
+
+  if (game && snapshot) {
+    GameArena_t *arena = (GameArena_t *)game;
+    memcpy(&game->core, snapshot, sizeof(game->core));
+    game->gameInfo = game->core.attached ? &arena->info : NULL;
+    game->curTetState = game->core.attached ? &game->core.piece : NULL;
+    err = 0;
+  }
+
+  return err;
+}
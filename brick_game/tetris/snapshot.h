@@ -0,0 +1,43 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл снимков состояния игры.
+
+  Снимок GameSnapshot_t - блок изменяемого состояния игры GameCore_t: битовое
+  поле со сторожевой рамкой, профиль поверхности, удаленные строки, генератор
+  фигур, текущая и следующая фигуры, состояние конечного автомата с очередью
+  событий, счетчики тактов и результаты. Блок расположен в начале Game_t и не
+  содержит указателей, поэтому снятие и восстановление снимка выполняются
+  одним присваиванием без пересчета производных данных и выделения памяти,
+  что позволяет хранить и размножать состояния для перебора ходов, отката и
+  отладки.
+
+  Цветовая плоскость поля в снимок не входит: вместе с масками строк она не
+  помещается в 256 байт. После восстановления занятость ячеек определяется
+  масками снимка, а цвета берутся из цветовой плоскости игры (занятые ячейки
+  без цвета отображаются значением BB_DEFAULT_COLOR).
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "tetris.h"
+
+/*!
+  \brief Тип снимка состояния игры.
+*/
+typedef GameCore_t GameSnapshot_t;
+
+_Static_assert(sizeof(GameSnapshot_t) <= 256,
+               "снимок состояния игры превышает 256 байт");
+
+/*!
+  \defgroup Snapshot_operations Функции снимков состояния игры
+  \brief Функции сохранения и восстановления полного состояния игры.
+*/
+int snapshotGame(const Game_t *game, GameSnapshot_t *snapshot);
+int restoreGame(Game_t *game, const GameSnapshot_t *snapshot);
+
+#endif  // SNAPSHOT_H
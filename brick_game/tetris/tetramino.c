@@ -0,0 +1,105 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл описаний фигур тетрамино.
+
+  Файл содержит базовые описания фигур и таблицу предвычисленных описаний
+  фигур во всех ориентациях. Таблица является константой времени компиляции:
+  ориентации ToRight, ToBottom и ToLeft получены последовательным поворотом
+  базового описания по часовой стрелке (ячейка (i, j) переходит в
+  (j, side - i - 1)), поэтому во время игры повороты не вычисляются и память не
+  выделяется.
+*/
+
+#include "tetris.h"
+
+#include <stddef.h>
+
+static const int i_type_tetramino[] = {0, 0, 0, 0, 1, 1, 1, 1,
+                                       0, 0, 0, 0, 0, 0, 0, 0};
+static const int o_type_tetramino[] = {2, 2, 2, 2};
+static const int t_type_tetramino[] = {0, 0, 0, 3, 3, 3, 0, 3, 0};
+static const int l_type_tetramino[] = {0, 0, 0, 4, 4, 4, 4, 0, 0};
+static const int j_type_tetramino[] = {0, 0, 0, 5, 5, 5, 0, 0, 5};
+static const int s_type_tetramino[] = {0, 0, 0, 0, 6, 6, 6, 6, 0};
+static const int z_type_tetramino[] = {0, 0, 0, 7, 7, 0, 0, 7, 7};
+
+static const Tetramino_t tetraminoes[TET_COUNT] = {
+    {i_type_tetramino, 4}, {o_type_tetramino, 2}, {t_type_tetramino, 3},
+    {l_type_tetramino, 3}, {j_type_tetramino, 3}, {s_type_tetramino, 3},
+    {z_type_tetramino, 3}};
+
+// clang-format off
+const TetraminoShape_t tetraminoShapes[TET_COUNT][TET_ORIENT_COUNT] = {
+    {  // I_TYPE
+        {{0x0, 0xF, 0x0, 0x0}, {{1, 0}, {1, 1}, {1, 2}, {1, 3}}, 1, 1, 0, 3},  // ToTop
+        {{0x4, 0x4, 0x4, 0x4}, {{0, 2}, {1, 2}, {2, 2}, {3, 2}}, 0, 3, 2, 2},  // ToRight
+        {{0x0, 0x0, 0xF, 0x0}, {{2, 0}, {2, 1}, {2, 2}, {2, 3}}, 2, 2, 0, 3},  // ToBottom
+        {{0x2, 0x2, 0x2, 0x2}, {{0, 1}, {1, 1}, {2, 1}, {3, 1}}, 0, 3, 1, 1},  // ToLeft
+    },
+    {  // O_TYPE
+        {{0x3, 0x3, 0x0, 0x0}, {{0, 0}, {0, 1}, {1, 0}, {1, 1}}, 0, 1, 0, 1},  // ToTop
+        {{0x3, 0x3, 0x0, 0x0}, {{0, 0}, {0, 1}, {1, 0}, {1, 1}}, 0, 1, 0, 1},  // ToRight
+        {{0x3, 0x3, 0x0, 0x0}, {{0, 0}, {0, 1}, {1, 0}, {1, 1}}, 0, 1, 0, 1},  // ToBottom
+        {{0x3, 0x3, 0x0, 0x0}, {{0, 0}, {0, 1}, {1, 0}, {1, 1}}, 0, 1, 0, 1},  // ToLeft
+    },
+    {  // T_TYPE
+        {{0x0, 0x7, 0x2, 0x0}, {{1, 0}, {1, 1}, {1, 2}, {2, 1}}, 1, 2, 0, 2},  // ToTop
+        {{0x2, 0x3, 0x2, 0x0}, {{0, 1}, {1, 0}, {1, 1}, {2, 1}}, 0, 2, 0, 1},  // ToRight
+        {{0x2, 0x7, 0x0, 0x0}, {{0, 1}, {1, 0}, {1, 1}, {1, 2}}, 0, 1, 0, 2},  // ToBottom
+        {{0x2, 0x6, 0x2, 0x0}, {{0, 1}, {1, 1}, {1, 2}, {2, 1}}, 0, 2, 1, 2},  // ToLeft
+    },
+    {  // L_TYPE
+        {{0x0, 0x7, 0x1, 0x0}, {{1, 0}, {1, 1}, {1, 2}, {2, 0}}, 1, 2, 0, 2},  // ToTop
+        {{0x3, 0x2, 0x2, 0x0}, {{0, 0}, {0, 1}, {1, 1}, {2, 1}}, 0, 2, 0, 1},  // ToRight
+        {{0x4, 0x7, 0x0, 0x0}, {{0, 2}, {1, 0}, {1, 1}, {1, 2}}, 0, 1, 0, 2},  // ToBottom
+        {{0x2, 0x2, 0x6, 0x0}, {{0, 1}, {1, 1}, {2, 1}, {2, 2}}, 0, 2, 1, 2},  // ToLeft
+    },
+    {  // J_TYPE
+        {{0x0, 0x7, 0x4, 0x0}, {{1, 0}, {1, 1}, {1, 2}, {2, 2}}, 1, 2, 0, 2},  // ToTop
+        {{0x2, 0x2, 0x3, 0x0}, {{0, 1}, {1, 1}, {2, 0}, {2, 1}}, 0, 2, 0, 1},  // ToRight
+        {{0x1, 0x7, 0x0, 0x0}, {{0, 0}, {1, 0}, {1, 1}, {1, 2}}, 0, 1, 0, 2},  // ToBottom
+        {{0x6, 0x2, 0x2, 0x0}, {{0, 1}, {0, 2}, {1, 1}, {2, 1}}, 0, 2, 1, 2},  // ToLeft
+    },
+    {  // S_TYPE
+        {{0x0, 0x6, 0x3, 0x0}, {{1, 1}, {1, 2}, {2, 0}, {2, 1}}, 1, 2, 0, 2},  // ToTop
+        {{0x1, 0x3, 0x2, 0x0}, {{0, 0}, {1, 0}, {1, 1}, {2, 1}}, 0, 2, 0, 1},  // ToRight
+        {{0x6, 0x3, 0x0, 0x0}, {{0, 1}, {0, 2}, {1, 0}, {1, 1}}, 0, 1, 0, 2},  // ToBottom
+        {{0x2, 0x6, 0x4, 0x0}, {{0, 1}, {1, 1}, {1, 2}, {2, 2}}, 0, 2, 1, 2},  // ToLeft
+    },
+    {  // Z_TYPE
+        {{0x0, 0x3, 0x6, 0x0}, {{1, 0}, {1, 1}, {2, 1}, {2, 2}}, 1, 2, 0, 2},  // ToTop
+        {{0x2, 0x3, 0x1, 0x0}, {{0, 1}, {1, 0}, {1, 1}, {2, 0}}, 0, 2, 0, 1},  // ToRight
+        {{0x3, 0x6, 0x0, 0x0}, {{0, 0}, {0, 1}, {1, 1}, {1, 2}}, 0, 1, 0, 2},  // ToBottom
+        {{0x4, 0x6, 0x2, 0x0}, {{0, 2}, {1, 1}, {1, 2}, {2, 1}}, 0, 2, 1, 2},  // ToLeft
+    },
+};
+// clang-format on
+
+/*!
+  \ingroup Data_manipulation Функции чтения и изменения данных
+  \brief Функция получения массива базовых описаний фигур.
+  \return Указатель на неизменяемый массив из TET_COUNT структур Tetramino_t.
+
+  Массив размещается в статической памяти, освобождение не требуется.
+*/
+const Tetramino_t *fillTatraminoes() { return tetraminoes; }
+
+/*!
+  \ingroup Data_manipulation Функции чтения и изменения данных
+  \brief Функция получения предвычисленного описания фигуры.
+  \param [in] index Индекс фигуры.
+  \param [in] orientation Ориентация фигуры.
+  \return Указатель на элемент таблицы tetraminoShapes или NULL при
+  недопустимых значениях параметров.
+*/
+const TetraminoShape_t *getTetraminoShape(tetraminoIndex_t index,
+                                          tetOrientation_t orientation) {
+  const TetraminoShape_t *shape = NULL;
+  if ((int)index >= 0 && (int)index < TET_COUNT && (int)orientation >= 0 &&
+      (int)orientation < TET_ORIENT_COUNT)
+    shape = &tetraminoShapes[index][orientation];
+  return shape;
+}
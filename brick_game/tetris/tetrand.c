@@ -0,0 +1,189 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Файл реализации генератора псевдослучайных чисел и генератора
+  последовательности фигур.
+*/
+
+#include "tetrand.h"
+
+#include <string.h>
+
+/*!
+  \brief Циклический сдвиг 32-битного значения влево.
+*/
+static inline uint32_t rotl32(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+/*!
+  \brief Шаг генератора splitmix64, используемого для развертки зерна.
+*/
+static uint64_t splitmix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция инициализации генератора по зерну.
+  \param [out] random Указатель на структуру TetRandom_t.
+  \param [in] seed Зерно генератора.
+
+  Одинаковое зерно всегда дает одинаковую последовательность чисел.
+*/
+void randomSeed(TetRandom_t *random, uint64_t seed) {
+  if (random) {
+    uint64_t a = splitmix64(&seed);
+    uint64_t b = splitmix64(&seed);
+    random->s[0] = (uint32_t)a;
+    random->s[1] = (uint32_t)(a >> 32);
+    random->s[2] = (uint32_t)b;
+    random->s[3] = (uint32_t)(b >> 32);
+    if (!(random->s[0] | random->s[1] | random->s[2] | random->s[3]))
+      random->s[0] = 1;
+  }
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция получения следующего 32-битного псевдослучайного числа.
+  \param [in,out] random Указатель на структуру TetRandom_t.
+  \return Псевдослучайное число.
+*/
+uint32_t randomNext(TetRandom_t *random) {
+  uint32_t *s = random->s;
+  const uint32_t result = rotl32(s[1] * 5u, 7) * 9u;
+  const uint32_t t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl32(s[3], 11);
+
+  return result;
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция получения равномерно распределенного числа из [0, bound).
+  \param [in,out] random Указатель на структуру TetRandom_t.
+  \param [in] bound Верхняя граница интервала (не включается), больше 0.
+  \return Псевдослучайное число.
+
+  Используется умножение с отбраковкой (метод Лемира): в отличие от взятия
+  остатка от деления результат не смещен, а деление выполняется только в редком
+  случае отбраковки.
+*/
+uint32_t randomBounded(TetRandom_t *random, uint32_t bound) {
+  uint64_t m = (uint64_t)randomNext(random) * bound;
+  uint32_t low = (uint32_t)m;
+
+  if (low < bound) {
+    uint32_t threshold = (0u - bound) % bound;
+    while (low < threshold) {
+      m = (uint64_t)randomNext(random) * bound;
+      low = (uint32_t)m;
+    }
+  }
+
+  return (uint32_t)(m >> 32);
+}
+
+/*!
+  \brief Функция формирования нового перемешанного набора фигур.
+*/
+static void sequenceRefillBag(TetSequence_t *sequence) {
+  for (int i = 0; i < TET_COUNT; i++) sequence->bag[i] = (uint8_t)i;
+  for (int i = TET_COUNT - 1; i > 0; i--) {
+    int j = (int)randomBounded(&sequence->random, (uint32_t)i + 1u);
+    uint8_t tmp = sequence->bag[i];
+    sequence->bag[i] = sequence->bag[j];
+    sequence->bag[j] = tmp;
+  }
+  sequence->bagPos = 0;
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция инициализации генератора последовательности фигур.
+  \param [out] sequence Указатель на структуру TetSequence_t.
+  \param [in] seed Зерно генератора.
+  \param [in] policy Политика формирования последовательности.
+*/
+void sequenceInit(TetSequence_t *sequence, uint64_t seed,
+                  tetSequencePolicy_t policy) {
+  if (sequence) {
+    memset(sequence, 0, sizeof(*sequence));
+    randomSeed(&sequence->random, seed);
+    sequence->policy = (uint8_t)policy;
+    sequence->bagPos = TET_COUNT;
+    for (int i = 0; i < TET_HISTORY_SIZE; i++)
+      sequence->history[i] = (uint8_t)(TET_COUNT - 1 - (i & 1));
+  }
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция получения индекса следующей фигуры.
+  \param [in,out] sequence Указатель на структуру TetSequence_t.
+  \return Индекс фигуры от 0 до TET_COUNT - 1.
+*/
+int sequenceNext(TetSequence_t *sequence) {
+  int index = 0;
+
+  if (sequence->policy == SequenceBag7) {
+    if (sequence->bagPos >= TET_COUNT) sequenceRefillBag(sequence);
+    index = sequence->bag[sequence->bagPos++];
+  } else if (sequence->policy == SequenceHistory) {
+    int inHistory = 1;
+    for (int roll = 0; roll < TET_HISTORY_ROLLS && inHistory; roll++) {
+      index = (int)randomBounded(&sequence->random, TET_COUNT);
+      inHistory = 0;
+      for (int i = 0; i < TET_HISTORY_SIZE; i++)
+        if (sequence->history[i] == index) inHistory = 1;
+    }
+    memmove(sequence->history + 1, sequence->history,
+            TET_HISTORY_SIZE - 1);
+    sequence->history[0] = (uint8_t)index;
+  } else {
+    index = (int)randomBounded(&sequence->random, TET_COUNT);
+  }
+
+  return index;
+}
+
+/*!
+  \ingroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функция получения нескольких следующих фигур.
+  \param [in,out] sequence Указатель на структуру TetSequence_t.
+  \param [out] out Массив для записи индексов фигур.
+  \param [in] count Количество фигур.
+
+  Результат совпадает с count последовательными вызовами sequenceNext().
+  Для политики SequenceBag7 фигуры копируются из набора целиком.
+*/
+void sequenceFill(TetSequence_t *sequence, uint8_t *out, int count) {
+  if (sequence && out) {
+    if (sequence->policy == SequenceBag7) {
+      while (count > 0) {
+        int chunk = 0;
+        if (sequence->bagPos >= TET_COUNT) sequenceRefillBag(sequence);
+        chunk = TET_COUNT - sequence->bagPos;
+        if (chunk > count) chunk = count;
+        memcpy(out, sequence->bag + sequence->bagPos, (size_t)chunk);
+        sequence->bagPos = (uint8_t)(sequence->bagPos + chunk);
+        out += chunk;
+        count -= chunk;
+      }
+    } else {
+      for (int i = 0; i < count; i++) out[i] = (uint8_t)sequenceNext(sequence);
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/*!
+  \file
+  \author provemet
+  \version 1
+  \date October 2024
+  \brief Заголовочный файл генератора псевдослучайных чисел и генератора
+  последовательности фигур.
+
+  Каждый экземпляр игры владеет собственным генератором xoshiro128**, который
+  инициализируется явно заданным зерном. Это делает последовательность фигур
+  воспроизводимой и позволяет выполнять независимые игры параллельно без общих
+  данных и блокировок.
+*/
+
+#ifndef TETRAND_H
+#define TETRAND_H
+
+#include <stdint.h>
+
+#include "gamepref.h"
+
+/*!
+  \brief Перечисление политик формирования последовательности фигур.
+*/
+typedef enum tetSequencePolicy_t {
+  SequenceUniform,  ///< Каждая фигура выбирается равновероятно.
+  SequenceBag7,  ///< Фигуры выдаются перемешанными наборами из TET_COUNT штук.
+  SequenceHistory  ///< Фигура перевыбирается, если она есть среди последних
+                   ///< выданных (TET_HISTORY_SIZE фигур, не более
+                   ///< TET_HISTORY_ROLLS попыток).
+} tetSequencePolicy_t;
+
+/*!
+  \brief Количество запоминаемых фигур для политики SequenceHistory.
+*/
+#define TET_HISTORY_SIZE 4
+
+/*!
+  \brief Количество попыток перевыбора фигуры для политики SequenceHistory.
+*/
+#define TET_HISTORY_ROLLS 6
+
+/*!
+  \brief Структура состояния генератора псевдослучайных чисел xoshiro128**.
+*/
+typedef struct TetRandom_t {
+  uint32_t s[4];  ///< Состояние генератора.
+} TetRandom_t;
+
+/*!
+  \brief Структура состояния генератора последовательности фигур.
+
+  Структура не содержит указателей и может копироваться присваиванием.
+*/
+typedef struct TetSequence_t {
+  TetRandom_t random;  ///< Генератор псевдослучайных чисел.
+  uint8_t policy;  ///< Политика формирования последовательности.
+  uint8_t bagPos;  ///< Индекс следующей фигуры в наборе.
+  uint8_t bag[TET_COUNT];  ///< Текущий перемешанный набор фигур.
+  uint8_t history[TET_HISTORY_SIZE];  ///< Последние выданные фигуры.
+} TetSequence_t;
+
+/*!
+  \defgroup Random_generation Функции генерации псевдослучайных значений
+  \brief Функции генерации чисел и последовательности фигур.
+*/
+void randomSeed(TetRandom_t *random, uint64_t seed);
+uint32_t randomNext(TetRandom_t *random);
+uint32_t randomBounded(TetRandom_t *random, uint32_t bound);
+void sequenceInit(TetSequence_t *sequence, uint64_t seed,
+                  tetSequencePolicy_t policy);
+int sequenceNext(TetSequence_t *sequence);
+void sequenceFill(TetSequence_t *sequence, uint8_t *out, int count);
+
+#endif  // TETRAND_H
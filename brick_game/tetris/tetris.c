@@ -10,7 +10,11 @@
 
 #include "tetris.h"
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "replay.h"
 
 /*!
   \ingroup Data_Structure_management Функции управления структурами данных
@@ -21,39 +25,198 @@
   Функция предназначена для создания основной структуры игры.
   В ходе выплолнения создаются структуры хранения состояния игрового поля,
   состояния фигуры, выполняется определение следующей фигуры, определяется
-  первичное состояние игры.
+  первичное состояние игры. Созданная структура регистрируется в локаторе
+  locateGame() и становится игрой, с которой работают функции userInput() и
+  updateCurrentState().
 */
 Game_t *createGame() {
+  Game_t *game = createGameCtx();
+
+  if (game) locateGame(game);
+
+  return game;
+}
+
+/*!
+  \ingroup Data_Structure_management Функции управления структурами данных
+  \brief Функция создания независимого экземпляра игры (контекста).
+  \return Указатель на область памяти созданной структуры или NULL при
+  возникновении исключений.
+
+  В отличие от createGame() структура не регистрируется в локаторе. Экземпляр
+  используется функциями с явной передачей контекста (userInputCtx(),
+  updateCurrentStateCtx(), tetris_step()), что позволяет размещать в одном
+  процессе произвольное количество независимых игр.
+*/
+Game_t *createGameCtx() { return createGameIn(NULL, 0); }
+
+/*!
+  \brief Функция связывания указателей области памяти игры с ее массивами.
+  \param [in,out] arena Указатель на структуру GameArena_t.
+
+  Указатели gameInfo и curTetState связываются, только если они заданы, так
+  как их отсутствие означает, что игра еще не начата.
+*/
+static void linkGameArena(GameArena_t *arena) {
+  arena->info.field = arena->fieldRows;
+  arena->info.next = arena->nextRows;
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    arena->fieldRows[i] = arena->fieldCells + i * GAME_BOARD_WIDTH;
+  for (int i = 0; i < TET_SIDE_MAX; i++)
+    arena->nextRows[i] = arena->nextCells + i * TET_SIDE_MAX;
+  if (arena->game.gameInfo) arena->game.gameInfo = &arena->info;
+  if (arena->game.curTetState)
+    arena->game.curTetState = &arena->game.core.piece;
+}
+
+/*!
+  \ingroup Data_Structure_management Функции управления структурами данных
+  \brief Функция создания экземпляра игры в заданной области памяти.
+  \param [in] memory Указатель на область памяти или NULL.
+  \param [in] size Размер области памяти в байтах.
+  \return Указатель на созданную структуру или NULL, если область памяти
+  меньше sizeof(GameArena_t), не выровнена на GAME_ARENA_ALIGN или не удалось
+  выделить память.
+
+  Все структуры игры размещаются в одной области GameArena_t, поэтому
+  создание, перезапуск и уничтожение игры не требуют отдельных выделений памяти
+  под поле, состояние игры и фигуры. Если memory равен NULL, область выделяется
+  функцией aligned_alloc() и освобождается функцией destroyGame(), иначе
+  памятью владеет вызывающая сторона.
+*/
+Game_t *createGameIn(void *memory, size_t size) {
+  GameArena_t *arena = NULL;
   Game_t *game = NULL;
 
-  if ((game = (Game_t *)malloc(sizeof(Game_t))) != NULL) {
+  if (!memory)
+    arena = (GameArena_t *)aligned_alloc(GAME_ARENA_ALIGN, sizeof(GameArena_t));
+  else if (size >= sizeof(GameArena_t) &&
+           (uintptr_t)memory % GAME_ARENA_ALIGN == 0)
+    arena = (GameArena_t *)memory;
+
+  if (arena) {
+    memset(arena, 0, sizeof(*arena));
+    linkGameArena(arena);
+    game = &arena->game;
     game->gameInfo = NULL;
     game->curTetState = NULL;
-    game->nextTetIndex = setRandomTetraminoIndex();
-    game->state = fsm_none;
-    game->modified = false;
-    locateGame(game);
+    game->tetraminoes = fillTatraminoes();
+    seedGame(game, GAME_DEFAULT_SEED, SequenceUniform);
+    game->core.state = fsm_none;
+    game->core.pausedState = fsm_none;
+    game->replay = NULL;
+    game->core.modified = false;
+    game->ownsArena = (memory == NULL);
+    game->core.tick = 0;
+    game->core.gravity = GAME_GRAVITY_US(1000000);
+    game->core.gravityCounter = 0;
+    game->core.lines = 0;
+    game->core.pieces = 0;
+    game->core.dasTicks = GAME_DAS_TICKS;
+    game->core.arrTicks = GAME_ARR_TICKS;
+    game->core.heldKeys = 0;
+    game->core.shiftAction = None;
+    game->core.lockTicks = GAME_LOCK_TICKS;
+    game->core.lockResetMax = GAME_LOCK_RESETS;
+    game->core.lockTimer = -1;
+    game->core.ghostRow = -1;
+    memset(&game->core.clearedRows, 0, sizeof(game->core.clearedRows));
+    bbClear(&game->core.board, &game->colors);
+    bbProfileBuild(&game->core.profile, &game->core.board);
   }
 
   return game;
 }
 
+/*!
+  \ingroup Data_Structure_management Функции управления структурами данных
+  \brief Функция перемещения экземпляра игры в другую область памяти.
+  \param [in] game Указатель на структуру Game_t.
+  \param [in] memory Указатель на новую область памяти или NULL.
+  \param [in] size Размер новой области памяти в байтах.
+  \return Указатель на игру в новой области памяти или NULL при ошибке (игра
+  при этом остается на прежнем месте).
+
+  Область копируется целиком, после чего внутренние указатели связываются с
+  новым расположением. Если игра зарегистрирована в локаторе, локатор
+  указывает на новый адрес. Прежняя область освобождается, если она выделялась
+  при создании игры. Требования к memory и size совпадают с createGameIn().
+*/
+Game_t *relocateGame(Game_t *game, void *memory, size_t size) {
+  GameArena_t *arena = NULL;
+  Game_t *moved = NULL;
+
+  if (game && !memory)
+    arena = (GameArena_t *)aligned_alloc(GAME_ARENA_ALIGN, sizeof(GameArena_t));
+  else if (game && size >= sizeof(GameArena_t) &&
+           (uintptr_t)memory % GAME_ARENA_ALIGN == 0)
+    arena = (GameArena_t *)memory;
+
+  if (arena && (Game_t *)arena == game) {
+    moved = game;
+  } else if (arena) {
+    bool located = (locateGame(NULL) == game);
+    bool owned = game->ownsArena;
+    memmove(arena, game, sizeof(*arena));
+    linkGameArena(arena);
+    moved = &arena->game;
+    moved->ownsArena = (memory == NULL);
+    if (located) locateGame(moved);
+    if (owned) free(game);
+  }
+
+  return moved;
+}
+
+/*!
+  \ingroup Data_Structure_management Функции управления структурами данных
+  \brief Функция подключения к игре структур состояния игры и фигуры.
+  \param [in,out] game Указатель на структуру Game_t, созданную функциями
+  createGameCtx() или createGameIn().
+  \return 0 - успешное выполнение, 1 - при отсутствии указателя.
+
+  Указатели gameInfo и curTetState связываются со структурами области памяти
+  игры, значения которых приводятся к состоянию по умолчанию, как у структур,
+  созданных функциями createGameInfo() и createTetraminoState().
+*/
+int attachGameInfo(Game_t *game) {
+  int err = 1;
+
+  if (game) {
+    GameArena_t *arena = (GameArena_t *)game;
+    memset(arena->fieldCells, 0, sizeof(arena->fieldCells));
+    memset(arena->nextCells, 0, sizeof(arena->nextCells));
+    memset(&game->core.piece, 0, sizeof(game->core.piece));
+    game->core.score = 0;
+    game->core.level = 1;
+    game->core.speed = 0;
+    game->core.pause = 0;
+    game->core.highScore = 0;
+    game->core.attached = 1;
+    game->gameInfo = &arena->info;
+    game->curTetState = &game->core.piece;
+    err = 0;
+  }
+
+  return err;
+}
+
 /*!
   \ingroup Data_Structure_management Функции управления структурами данных
   \brief Функция очистки игровой структуры Game_t
   \param [in] game Указатель на область памяти занимаемой структурой Game_t.
 
   Функция предназначена для очистки данных экземпляра структуры игры.
-  В ходе выплолнения данные предыдущей игры уничтожаются, структура приводится к
-  состоянию по умолчанию.
+  В ходе выплолнения данные предыдущей игры отключаются от структуры, структура
+  приводится к состоянию по умолчанию. Память структур остается в области
+  памяти игры и переиспользуется при следующем запуске.
 */
 void clearGame(Game_t *game) {
   if (game) {
-    game->state = fsm_none;
-    if (game->gameInfo)
-      destroyGameInfo(game->gameInfo);
-    if (game->curTetState) 
-      destorytetraminoState(game->curTetState);
+    game->core.state = fsm_none;
+    game->core.attached = 0;
+    game->gameInfo = NULL;
+    game->curTetState = NULL;
   }
 }
 
@@ -63,15 +226,13 @@ void clearGame(Game_t *game) {
   \param [in] game Указатель на область памяти занимаемой структурой Game_t.
 
   Функция предназначена для уничтожения экземпляра структуры игры.
-  В ходе выплолнения уничтожаются освобождается память от экземпляров всех
-  структур, являющихся членами данной.
+  Область памяти игры освобождается, только если она была выделена при
+  создании игры.
 */
 void destroyGame(Game_t *game) {
   if (game) {
-    if (game->gameInfo != NULL) destroyGameInfo(game->gameInfo);
-    if (game->curTetState != NULL) destorytetraminoState(game->curTetState);
-    locateGame(game);
-    free(game);
+    if (locateGame(NULL) == game) locateGame(game);
+    if (game->ownsArena) free(game);
     game = NULL;
   }
 }
@@ -90,11 +251,12 @@ GameInfo_t *createGameInfo() {
   if (gameinfo) {
     if ((gameinfo->field =
             createGameField(GAME_BOARD_HEIGHT, GAME_BOARD_WIDTH))) {
-      gameinfo->next = NULL;
+      gameinfo->next = createGameField(TET_SIDE_MAX, TET_SIDE_MAX);
       gameinfo->score = 0;
       gameinfo->level = 1;
       gameinfo->speed = 0;
       gameinfo->pause = 0;
+      gameinfo->high_score = 0;
       //gameinfo->high_score = getHighScore();
     } else
       destroyGameInfo(gameinfo);
@@ -120,6 +282,7 @@ void destroyGameInfo(GameInfo_t *gameinfo) {
     // }
     if (gameinfo->field) 
       destroyGameField(gameinfo->field);
+    if (gameinfo->next) destroyGameField(gameinfo->next);
     free(gameinfo);
     gameinfo = NULL;
   }
@@ -220,30 +383,6 @@ Game_t* locateGame(Game_t* game) {
   return location.addr;
 }
 
-// Tetramino_t** fillTatraminoes() {
-//   const int i_type_tetramino[] = {0, 0, 0, 0, 1, 1, 1, 1,
-//                                        0, 0, 0, 0, 0, 0, 0, 0};
-//   const int o_type_tetramino[] = {2, 2, 2, 2};
-//   const int t_type_tetramino[] = {0, 0, 0, 3, 3, 3, 0, 3, 0};
-//   const int l_type_tetramino[] = {0, 0, 0, 4, 4, 4, 4, 0, 0};
-//   const int j_type_tetramino[] = {0, 0, 0, 5, 5, 5, 0, 0, 5};
-//   const int s_type_tetramino[] = {0, 0, 0, 0, 6, 6, 6, 6, 0};
-//   const int z_type_tetramino[] = {0, 0, 0, 7, 7, 0, 0, 7, 7};
-
-//   Tetramino_t** tetraminoes = (Tetramino_t **)malloc(sizeof(Tetramino_t*) *
-//   TET_COUNT); if (tetraminoes) {
-//     tetraminoes[0] = {i_type_tetramino, 4};
-//     tetraminoes[1] = {o_type_tetramino, 2};
-//     tetraminoes[2] = {t_type_tetramino, 3};
-//     tetraminoes[3] = {l_type_tetramino, 3};
-//     tetraminoes[4] = {j_type_tetramino, 3};
-//     tetraminoes[5] = {s_type_tetramino, 3};
-//     tetraminoes[6] = {z_type_tetramino, 3};
-//   }
-
-//   return tetraminoes;
-// }
-
 // void updateGameState(GameInfo_t *game){
 //   if (game->pause) {
 
@@ -305,17 +444,92 @@ int setCellValue(int **gameboard, int rowindex, int colindex, int val) {
   \ingroup Data_manipulation Функции чтения и изменения данных
   \brief Функция выбора индекса случайной фигуры.
   \return Произвольное целое в интевале между 0 и TET_COUNT
+
+  Функция использует общий для процесса генератор rand() и оставлена для
+  совместимости. Игровой движок выбирает фигуры генератором экземпляра игры
+  (см. seedGame()).
 */
 inline int setRandomTetraminoIndex() { return rand() % TET_COUNT; }
 
+/*!
+  \ingroup Data_manipulation Функции чтения и изменения данных
+  \brief Функция задания зерна и политики генератора фигур экземпляра игры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] seed Зерно генератора.
+  \param [in] policy Политика формирования последовательности фигур.
+
+  Генератор принадлежит экземпляру игры, поэтому игры с одинаковым зерном,
+  политикой и действиями пользователя развиваются одинаково независимо от
+  других игр процесса. Следующая фигура выбирается заново.
+*/
+void seedGame(Game_t *game, uint64_t seed, tetSequencePolicy_t policy) {
+  if (game) {
+    game->core.seed = seed;
+    sequenceInit(&game->core.sequence, seed, policy);
+    game->core.nextTetIndex = sequenceNext(&game->core.sequence);
+  }
+}
+
+/*!
+  \ingroup Data_manipulation Функции чтения и изменения данных
+  \brief Функция задания параметров автоповтора удерживаемых клавиш.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] dasTicks Задержка до первого автоповтора в тактах (DAS).
+  \param [in] arrTicks Интервал автоповтора в тактах (ARR), 0 - смещение до
+  препятствия за один такт.
+  \return 0 - успешное выполнение, 1 - значения вне диапазона [0, INT16_MAX]
+  или нет указателя.
+*/
+int setAutoShift(Game_t *game, int dasTicks, int arrTicks) {
+  int err = !game || dasTicks < 0 || arrTicks < 0 || dasTicks > INT16_MAX ||
+            arrTicks > INT16_MAX;
+
+  if (!err) {
+    game->core.dasTicks = dasTicks;
+    game->core.arrTicks = arrTicks;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Data_manipulation Функции чтения и изменения данных
+  \brief Функция задания параметров задержки фиксации фигуры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] lockTicks Задержка фиксации лежащей фигуры в тактах, 0 - без
+  задержки: фигура фиксируется, когда гравитация не может сместить ее вниз.
+  \param [in] lockResets Допустимое количество перезапусков задержки
+  смещениями и поворотами фигуры.
+  \return 0 - успешное выполнение, 1 - значения вне диапазона [0, INT16_MAX]
+  или нет указателя.
+*/
+int setLockDelay(Game_t *game, int lockTicks, int lockResets) {
+  int err = !game || lockTicks < 0 || lockResets < 0 ||
+            lockTicks > INT16_MAX || lockResets > INT16_MAX;
+
+  if (!err) {
+    game->core.lockTicks = lockTicks;
+    game->core.lockResetMax = lockResets;
+  }
+
+  return err;
+}
+
+/*!
+  \brief Функция обработки действия "Вращение фигуры"
+
+  Новая ориентация является индексом в таблице tetraminoShapes, поэтому
+  описание повернутой фигуры не вычисляется, а выбирается из таблицы.
+*/
 int rotateTetramino(TetraminoState_t *tetState,
                     const tetRotateDirection_t chdir) {
   int err = 1;
 
   if (tetState) {
-    tetState->orientation = abs((tetState->orientation + chdir) % 4);
-  } else
+    tetState->orientation =
+        (tetState->orientation + TET_ORIENT_COUNT + chdir) % TET_ORIENT_COUNT;
     err = 0;
+  }
 
   return err;
 }
@@ -340,44 +554,84 @@ int moveTetramino(TetraminoState_t *tetState,
   return err;
 }
 
-// int checkCollision(GameInfo_t *gameinfo, TetraminoState_t *tetState) {
-//   int isCollided = 0;
-
-//   if (gameinfo && tetState) {
-//     int tetside = Tetraminoes[tetState->tetraminoIndex].side;
-//     for (int i = 0; i < tetside; i++) {
-//       for (int j = 0; j < tetside; j++) {
-//         if ((tetState->orientation == ToTop &&
-//              getCellValue(gameinfo->field, i + tetState->offsetRow,
-//                           j + tetState->offsetCol) != 0 &&
-//              Tetraminoes[tetState->tetraminoIndex].data[i * tetside + j]) ||
-//             (tetState->orientation == ToRight &&
-//              getCellValue(gameinfo->field, i + tetState->offsetRow,
-//                           j + tetState->offsetCol) != 0 &&
-//              Tetraminoes[tetState->tetraminoIndex]
-//                  .data[j * tetside + (tetside - i - 1)]) ||
-//             (tetState->orientation == ToBottom &&
-//              getCellValue(gameinfo->field, i + tetState->offsetRow,
-//                           j + tetState->offsetCol) != 0 &&
-//              Tetraminoes[tetState->tetraminoIndex]
-//                  .data[(tetside - i - 1) * tetside + (tetside - j - 1)]) ||
-//             (tetState->orientation == ToLeft &&
-//              getCellValue(gameinfo->field, i + tetState->offsetRow,
-//                           j + tetState->offsetCol) != 0 &&
-//              Tetraminoes[tetState->tetraminoIndex]
-//                  .data[(tetside - j - 1) * tetside + i])) {
-//           isCollided = 1;
-//           break;
-//         }
-//       }
-//       if (isCollided) {
-//         break;
-//       }
-//     }
-//   }
+/*!
+  \brief Функция проверки коллизий расположения фигуры относительно игрового
+  поля, представленного двумерным массивом ячеек.
 
-//   return isCollided;
-// }
+  Функция перебирает список ячеек фигуры из таблицы tetraminoShapes.
+*/
+int checkCollision(GameInfo_t *gameinfo, TetraminoState_t *tetState) {
+  int isCollided = 0;
+
+  if (gameinfo && tetState) {
+    const TetraminoShape_t *shape =
+        getTetraminoShape(tetState->tetraminoIndex, tetState->orientation);
+    for (int i = 0; shape && i < TET_CELLS && !isCollided; i++) {
+      int row = tetState->offsetRow + shape->cells[i].row;
+      int col = tetState->offsetCol + shape->cells[i].col;
+      if (row >= GAME_BOARD_HEIGHT || col < 0 || col >= GAME_BOARD_WIDTH)
+        isCollided = 1;
+      else if (row >= 0 && gameinfo->field[row][col] != 0)
+        isCollided = 1;
+    }
+    if (!shape) isCollided = 1;
+  }
+
+  return isCollided;
+}
+
+/*!
+  \brief Функция проверки коллизий расположения фигуры относительно битового
+  игрового поля.
+  \param [in] board Указатель на структуру BitBoard_t.
+  \param [in] tetState Указатель на структуру TetraminoState_t.
+  \return 0 - если функция не нашла пересечений, 1 - при наличии коллизий или
+  отсутствии указателей.
+
+  Функция сравнивает маски строк фигуры из таблицы tetraminoShapes со строками
+  игрового поля.
+*/
+int checkBoardCollision(const BitBoard_t *board,
+                        const TetraminoState_t *tetState) {
+  int isCollided = 1;
+
+  if (board && tetState) {
+    const TetraminoShape_t *shape =
+        getTetraminoShape(tetState->tetraminoIndex, tetState->orientation);
+    if (shape)
+      isCollided = bbCollides(board, shape->rows, TET_SIDE_MAX,
+                              tetState->offsetRow, tetState->offsetCol);
+  }
+
+  return isCollided;
+}
+
+/*!
+  \ingroup Functions_getting_data_structure_for_rendering Функции получения
+  данных для рендера
+  \brief Функция нанесения фигуры на двумерный массив ячеек.
+  \param [out] field Двумерный массив значений ячеек.
+  \param [in] rows Количество строк массива.
+  \param [in] cols Количество столбцов массива.
+  \param [in] tetState Указатель на состояние фигуры.
+
+  Функция перебирает список ячеек фигуры из таблицы tetraminoShapes, ячейки за
+  пределами массива пропускаются.
+*/
+void drawTetramino(int **field, const int rows, const int cols,
+                   const TetraminoState_t *tetState) {
+  const TetraminoShape_t *shape =
+      tetState ? getTetraminoShape(tetState->tetraminoIndex,
+                                   tetState->orientation)
+               : NULL;
+
+  for (int i = 0; field && shape && i < TET_CELLS; i++) {
+    int row = tetState->offsetRow + shape->cells[i].row;
+    int col = tetState->offsetCol + shape->cells[i].col;
+    if (row >= 0 && row < rows && col >= 0 && col < cols)
+      field[row][col] = (int)tetState->tetraminoIndex + 1;
+  }
+}
 
 /*!
   \ingroup Functions_getting_data_structure_for_rendering Функции получения
@@ -386,161 +640,762 @@ int moveTetramino(TetraminoState_t *tetState,
   \return Структура обмена GameInfo_t
  */
 GameInfo_t updateCurrentState() {
+  return updateCurrentStateCtx(locateGame(NULL));
+}
+
+/*!
+  \ingroup Functions_getting_data_structure_for_rendering Функции получения
+  данных для рендера
+  \brief Функции получения данных в виде структуры для заданного экземпляра
+  игры.
+  \param [in] game_ptr Указатель на структуру Game_t.
+  \return Структура обмена GameInfo_t
+
+  Структура gameInfo игры заполняется из блока состояния Game_t::core и
+  возвращается копией.
+ */
+GameInfo_t updateCurrentStateCtx(Game_t *game_ptr) {
   GameInfo_t game_info = {0};
-  Game_t *game_ptr = locateGame(NULL);
 
-  if (game_ptr) {
-    game_info.field = game_ptr->gameInfo->field;
-    game_info.high_score = game_ptr->gameInfo->high_score;
-    game_info.level = game_ptr->gameInfo->level;
-    game_info.next = game_ptr->gameInfo->next;
-    game_info.pause = game_ptr->gameInfo->pause;
-    game_info.score = game_ptr->gameInfo->score;
-    game_info.speed = game_ptr->gameInfo->speed;
+  if (game_ptr && game_ptr->gameInfo) {
+    GameInfo_t *info = game_ptr->gameInfo;
+    exportGameField(game_ptr, info->field, info->next);
+    info->score = game_ptr->core.score;
+    info->high_score = game_ptr->core.highScore;
+    info->level = game_ptr->core.level;
+    info->speed = game_ptr->core.speed;
+    info->pause = game_ptr->core.pause;
+    game_info = *info;
   }
 
   return game_info;
 }
 
+/*!
+  \ingroup Functions_getting_data_structure_for_rendering Функции получения
+  данных для рендера
+  \brief Функция выгрузки игрового поля с текущей фигурой и следующей фигуры
+  в двумерные массивы.
+  \param [in] game Указатель на структуру Game_t.
+  \param [out] field Массив GAME_BOARD_HEIGHT x GAME_BOARD_WIDTH или NULL.
+  \param [out] next Массив TET_SIDE_MAX x TET_SIDE_MAX или NULL.
+
+  Массивы могут принадлежать как самой игре (updateCurrentStateCtx()), так и
+  снимку кадра, передаваемому в другой поток.
+*/
+void exportGameField(const Game_t *game, int **field, int **next) {
+  if (game && field) {
+    bbExportField(&game->core.board, &game->colors, field);
+    if (game->curTetState && game->core.state == fsm_move)
+      drawTetramino(field, GAME_BOARD_HEIGHT, GAME_BOARD_WIDTH,
+                    game->curTetState);
+  }
+  if (game && next) {
+    TetraminoState_t nextState = {game->core.nextTetIndex, 0, 0, ToTop};
+    for (int i = 0; i < TET_SIDE_MAX; i++)
+      for (int j = 0; j < TET_SIDE_MAX; j++) next[i][j] = 0;
+    drawTetramino(next, TET_SIDE_MAX, TET_SIDE_MAX, &nextState);
+  }
+}
+
+/*!
+  \ingroup Functions_getting_data_structure_for_rendering Функции получения
+  данных для рендера
+  \brief Функция выгрузки проекции текущей фигуры на опору.
+  \param [in] game Указатель на структуру Game_t.
+  \param [out] field Массив GAME_BOARD_HEIGHT x GAME_BOARD_WIDTH, заполненный
+  функцией exportGameField().
+
+  Пустые ячейки поля, которые займет фигура при падении, получают значение
+  TET_GHOST_CELL. Строка падения берется из GameCore_t::ghostRow, поэтому
+  функция не выполняет проверок коллизий.
+*/
+void exportGhost(const Game_t *game, int **field) {
+  int ghostRow = getGhostRow(game);
+
+  if (field && ghostRow >= 0) {
+    const TetraminoShape_t *shape = &tetraminoShapes
+        [game->curTetState->tetraminoIndex][game->curTetState->orientation];
+    for (int i = 0; i < TET_CELLS; i++) {
+      int row = ghostRow + shape->cells[i].row;
+      int col = game->curTetState->offsetCol + shape->cells[i].col;
+      if (row >= 0 && row < GAME_BOARD_HEIGHT && col >= 0 &&
+          col < GAME_BOARD_WIDTH && !field[row][col])
+        field[row][col] = TET_GHOST_CELL;
+    }
+  }
+}
+
+/*!
+  \ingroup Functions_getting_data_structure_for_rendering Функции получения
+  данных для рендера
+  \brief Функция получения строки падения текущей фигуры.
+  \param [in] game Указатель на структуру Game_t.
+  \return Смещение по вертикали, на котором текущая фигура ляжет на опору,
+  или -1, если фигура не перемещается.
+
+  Значение вычисляется при появлении, смещении и повороте фигуры и хранится в
+  экземпляре игры, поэтому запрос не требует вычислений.
+*/
+int getGhostRow(const Game_t *game) {
+  int ghostRow = -1;
+
+  if (game && game->curTetState && game->core.state == fsm_move)
+    ghostRow = game->core.ghostRow;
+
+  return ghostRow;
+}
+
 /*!
   \brief Функция обработки ввода пользователя
   \param [in] action Вид действия пользователя, определенное enum UserAction_t
-  \param [in] hold Пока не понял нафига
+  \param [in] hold Признак удержания клавиши (см. userInputCtx()).
   \details Функция выполняет обработку действий пользователя, определенные в
   соответсвии с матрицей состояний машины конечных автоматов.
 */
 void userInput(UserAction_t action, bool hold) {
-  actfunc act = NULL;
-  Game_t *game = locateGame(NULL);
-  bool holdstate = hold;
+  userInputCtx(locateGame(NULL), action, hold);
+}
 
-  if (game) {
-    holdstate = false; //пока не понял нафига. Заглушка.
-    act = fsm(game->state, action);
+/*!
+  \brief Функция учета удержания клавиш смещения.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] action Действие Left, Right или Down.
+  \param [in] hold Признак удержания клавиши.
+  \return true - если смещение необходимо выполнить сразу.
+
+  Нажатие с признаком удержания выполняет смещение и запускает отсчет задержки
+  автоповтора, повторные нажатия удерживаемой клавиши игнорируются. Действие
+  без признака удержания для удерживаемой клавиши означает ее отпускание, для
+  остальных клавиш - однократное нажатие. Из двух удерживаемых клавиш
+  смещения по горизонтали действует нажатая последней.
+*/
+static bool holdShiftKey(Game_t *game, UserAction_t action, bool hold) {
+  bool held = game->core.heldKeys & HOLD_BIT(action), act = !held;
+
+  if (hold && !held) {
+    game->core.heldKeys |= HOLD_BIT(action);
+    if (action == Down) {
+      game->core.dropTimer = game->core.dasTicks;
+    } else {
+      game->core.shiftAction = action;
+      game->core.shiftTimer = game->core.dasTicks;
+    }
+  } else if (!hold && held) {
+    UserAction_t other = action == Left ? Right : Left;
+    game->core.heldKeys &= ~HOLD_BIT(action);
+    if ((int)action == game->core.shiftAction) {
+      game->core.shiftAction =
+          (game->core.heldKeys & HOLD_BIT(other)) ? other : None;
+      game->core.shiftTimer = game->core.dasTicks;
+    }
   }
 
-  if (holdstate) holdstate = true;
+  return act;
+}
+
+/*!
+  \brief Функция обработки ввода пользователя для заданного экземпляра игры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] action Вид действия пользователя, определенное enum UserAction_t
+  \param [in] hold Признак удержания клавиши. Для действий Left, Right и Down
+  true означает нажатие удерживаемой клавиши: фигура смещается сразу, а затем
+  автоматически через dasTicks тактов и далее каждые arrTicks тактов, пока
+  действие не будет передано с hold = false (отпускание). Интерфейсы, которые
+  не получают событий отпускания клавиш, передают hold = false, и каждое
+  действие выполняется однократно.
+
+  Действие помещается в очередь событий, после чего очередь обрабатывается.
+  Если очередь заполнена, накопленные события обрабатываются до помещения
+  действия.
+*/
+void userInputCtx(Game_t *game, UserAction_t action, bool hold) {
+  if (postUserInput(game, action, hold)) {
+    dispatchEvents(game);
+    postUserInput(game, action, hold);
+  }
+  dispatchEvents(game);
+}
+
+/*!
+  \ingroup Fsm_events Функции очереди событий конечного автомата
+  \brief Функция помещения действия пользователя в очередь событий.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] action Вид действия пользователя.
+  \param [in] hold Признак удержания клавиши (см. userInputCtx()).
+
+  Действие записывается в повтор и учитывается в маске удерживаемых клавиш
+  сразу, а выполняется при обработке очереди функцией dispatchEvents(). Это
+  позволяет передать несколько действий и обработать их за один проход.
+  \return 0 - действие принято, 1 - очередь заполнена: действие не записано и
+  не учтено, очередь необходимо обработать и передать действие повторно.
+*/
+int postUserInput(Game_t *game, UserAction_t action, bool hold) {
+  int err = game && game->core.eventCount == GAME_EVENT_QUEUE;
+
+  if (!err && game && action != None) {
+    if (game->replay)
+      replayRecord(game->replay, game->core.tick, action, hold);
+    if ((action != Left && action != Right && action != Down) ||
+        holdShiftKey(game, action, hold))
+      postEvent(game, action);
+  }
 
-  if (act) act(game);
+  return err;
 }
 
-actfunc fsm(fsm_state_t state, UserAction_t userAction) {
+/*!
+  \ingroup Fsm_events Функции очереди событий конечного автомата
+  \brief Функция помещения события в очередь экземпляра игры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] event Действие пользователя (UserAction_t) или внутреннее
+  событие (fsmEvent_t).
+
+  \return 0 - событие помещено в очередь, 1 - очередь заполнена или неверное
+  событие.
+
+  Заполненная очередь не обрабатывается неявно: все события обрабатываются
+  одним проходом dispatchEvents(). Обработчики помещают в очередь не более
+  одного события, а dispatchEvents() освобождает место перед вызовом
+  обработчика, поэтому внутренние события всегда помещаются в очередь.
+*/
+int postEvent(Game_t *game, int event) {
+  int err = !game || event <= None || event >= FsmEventCount ||
+            game->core.eventCount == GAME_EVENT_QUEUE;
+
+  if (!err) {
+    game->core.events[(game->core.eventHead + game->core.eventCount) %
+                      GAME_EVENT_QUEUE] = (uint8_t)event;
+    game->core.eventCount++;
+  }
+
+  return err;
+}
+
+/*!
+  \ingroup Fsm_events Функции очереди событий конечного автомата
+  \brief Функция обработки очереди событий экземпляра игры.
+  \param [in,out] game Указатель на структуру Game_t.
+
+  События извлекаются в порядке поступления, и для каждого вызывается
+  обработчик из таблицы переходов для текущего состояния. События, которые
+  помещают в очередь сами обработчики, обрабатываются в том же проходе.
+*/
+void dispatchEvents(Game_t *game) {
+  while (game && game->core.eventCount > 0) {
+    int event = game->core.events[game->core.eventHead];
+    actfunc act = NULL;
+    game->core.eventHead =
+        (uint8_t)((game->core.eventHead + 1) % GAME_EVENT_QUEUE);
+    game->core.eventCount--;
+    if ((act = fsm(game->core.state, event)) != NULL) act(game);
+  }
+}
+
+/*!
+  \brief Таблица переходов конечного автомата.
+
+  Строки соответствуют состояниям fsm_state_t, столбцы - событиям: действиям
+  пользователя UserAction_t и внутренним событиям fsmEvent_t. Пустая ячейка
+  означает, что событие в данном состоянии не обрабатывается.
+*/
+static const actfunc fsmTable[FSM_STATE_COUNT][FsmEventCount] = {
+    // None, Start, Pause, Terminate, Left, Right, Up, Down, Action,
+    // Tick, Lock, Clear
+    [fsm_none] = {[Start] = start_fn, [Terminate] = terminate_fn},
+    [fsm_start] = {[Pause] = pause_fn,
+                   [Terminate] = terminate_fn,
+                   [FsmTick] = spawn_fn},
+    [fsm_pause] = {[Start] = pause_fn,
+                   [Pause] = pause_fn,
+                   [Terminate] = terminate_fn},
+    [fsm_spawn] = {[Pause] = pause_fn,
+                   [Terminate] = terminate_fn,
+                   [FsmTick] = spawn_fn,
+                   [FsmClear] = spawn_fn},
+    [fsm_move] = {[Pause] = pause_fn,
+                  [Terminate] = terminate_fn,
+                  [Left] = left_fn,
+                  [Right] = right_fn,
+                  [Up] = up_fn,
+                  [Down] = down_fn,
+                  [Action] = action_fn,
+                  [FsmTick] = move_fn},
+    [fsm_connect] = {[Terminate] = terminate_fn, [FsmLock] = connect_fn},
+    [fsm_gameover] = {[Start] = start_fn, [Terminate] = terminate_fn},
+    [fsm_exit] = {NULL}};
+
+/*!
+  \brief Функция выбора обработчика события по таблице переходов.
+  \param [in] state Текущее состояние автомата.
+  \param [in] event Действие пользователя или внутреннее событие.
+  \return Указатель на обработчик или NULL, если событие не обрабатывается.
+*/
+actfunc fsm(fsm_state_t state, int event) {
   actfunc callfunc = NULL;
-  //Матрица предварительно накидана, нужно будет уточнять по состоянию.
-  actfunc fsmMatrix[8][9] = {
-      // None, Start, Pause, Terminate, Left, Right, Up, Down, Action
-      {NULL, start_fn, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},  // none
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      {NULL, NULL, NULL, terminate_fn, NULL, NULL, NULL, NULL, NULL},
-      // {spawn_fn, NULL, pause_fn, terminate_fn, NULL, NULL, NULL, NULL,
-      //  NULL},  // start
-      // {NULL, NULL, pause_fn, terminate_fn, NULL, NULL, NULL, NULL,
-      //  NULL},  // pause
-      // {NULL, NULL, pause_fn, terminate_fn, left_fn, right_fn, up_fn, down_fn,
-      //  action_fn},  // spawn
-      // {NULL, NULL, pause_fn, terminate_fn, left_fn, right_fn, up_fn, down_fn,
-      //  action_fn},                                                 // move
-      // {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},      // shift
-      // {spawn_fn, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},  // connect
-      // {NULL, start_fn, NULL, terminate_fn, NULL, NULL, NULL, NULL,
-      //  NULL}  // game_over
-  };
-
-  callfunc = fsmMatrix[(int)state][(int)userAction];
+
+  if ((int)state >= 0 && state < FSM_STATE_COUNT && event >= 0 &&
+      event < FsmEventCount)
+    callfunc = fsmTable[state][event];
 
   return callfunc;
 }
 
 void start_fn(Game_t* game) {
   if (game) {
-    if ((game->gameInfo = createGameInfo())) {
-      if ((game->curTetState = createTetraminoState())) {
-        game->nextTetIndex = setRandomTetraminoIndex();
-        game->state = fsm_start;
-      } else {
-        destroyGameInfo(game->gameInfo);
-      }
+    int high_score = game->gameInfo ? game->core.highScore : 0;
+    clearGame(game);
+    if (!attachGameInfo(game)) {
+      bbClear(&game->core.board, &game->colors);
+      bbProfileBuild(&game->core.profile, &game->core.board);
+      game->core.highScore = high_score;
+      game->core.speed = GAME_SPEED_DEFAULT;
+      game->core.lines = 0;
+      game->core.pieces = 0;
+      game->core.gravityCounter = 0;
+      updateLevel(game);
+      game->core.state = fsm_start;
     }
   }
 }
 
 void terminate_fn(Game_t* game) {
   if (game) {
-    game->state = fsm_exit;
+    game->core.state = fsm_exit;
   }
 }
 
 void pause_fn(Game_t* game) {
   if (game) {
-    static fsm_state_t temp_state;
-    if (game->gameInfo->pause) {
-      game->state = temp_state;
-      game->gameInfo->pause = 0;
+    if (game->core.pause) {
+      game->core.state = game->core.pausedState;
+      game->core.pause = 0;
+    } else {
+      game->core.pausedState = game->core.state;
+      game->core.pause = 1;
+      game->core.state = fsm_pause;
+    }
+  }
+}
+
+/*!
+  \brief Функция пересчета строки падения текущей фигуры.
+  \param [in,out] game Указатель на структуру Game_t.
+
+  Вызывается после появления, смещения по горизонтали и поворота фигуры.
+  Смещение вниз строку падения не меняет.
+*/
+static void updateGhost(Game_t* game) {
+  const TetraminoShape_t* shape = &tetraminoShapes
+      [game->curTetState->tetraminoIndex][game->curTetState->orientation];
+
+  game->core.ghostRow = (int8_t)bbDropRow(
+      &game->core.board, &game->core.profile, shape->rows, TET_SIDE_MAX,
+      game->curTetState->offsetRow, game->curTetState->offsetCol);
+}
+
+/*!
+  \brief Функция обновления задержки фиксации после смещения фигуры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] reset Признак смещения или поворота, которое перезапускает
+  задержку фиксации лежащей фигуры.
+
+  Фигура лежит на опоре, если находится на строке падения ghostRow. Если
+  фигура коснулась опоры, запускается отсчет задержки фиксации. Если
+  фигура лежит на опоре, смещение перезапускает отсчет не более lockResetMax
+  раз; счетчик перезапусков обнуляется, когда фигура опускается ниже, чем
+  была. Если фигура больше не лежит на опоре, отсчет прекращается. Повторное
+  касание опоры после смещения или поворота на той же высоте считается
+  перезапуском: когда перезапуски исчерпаны, фигура фиксируется в следующем
+  такте. Без задержки фиксации (lockTicks = 0) отсчет не запускается: фигуру
+  фиксирует shift_fn(), когда гравитация не может сместить ее вниз.
+*/
+static void updateLock(Game_t* game, bool reset) {
+  bool lowered = game->curTetState->offsetRow > game->core.lowestRow;
+
+  if (lowered) {
+    game->core.lowestRow = game->curTetState->offsetRow;
+    game->core.lockResets = 0;
+  }
+  if (game->curTetState->offsetRow < game->core.ghostRow ||
+      !game->core.lockTicks) {
+    game->core.lockTimer = -1;
+  } else if (game->core.lockTimer < 0 && (!reset || lowered)) {
+    game->core.lockTimer = game->core.lockTicks;
+    game->core.lockAge = 0;
+  } else if (game->core.lockTimer < 0) {
+    if (game->core.lockResets < game->core.lockResetMax) {
+      game->core.lockResets++;
+      game->core.lockTimer = game->core.lockTicks;
     } else {
-      temp_state = game->state;
-      game->gameInfo->pause = 1;
-      game->state = fsm_pause;
+      game->core.lockTimer = 0;
     }
+  } else if (reset && game->core.lockResets < game->core.lockResetMax) {
+    game->core.lockResets++;
+    game->core.lockTimer = game->core.lockTicks;
   }
 }
 
+/*!
+  \brief Функция появления новой фигуры.
+
+  Следующая фигура становится текущей и размещается по центру верхней границы
+  игрового поля. Если разместить фигуру не удается, игра завершается.
+*/
 void spawn_fn(Game_t* game) {
+  if (game && game->curTetState) {
+    const TetraminoShape_t* shape =
+        &tetraminoShapes[game->core.nextTetIndex][ToTop];
+    game->curTetState->tetraminoIndex = game->core.nextTetIndex;
+    game->curTetState->orientation = ToTop;
+    game->curTetState->offsetRow = -shape->top;
+    game->curTetState->offsetCol =
+        (GAME_BOARD_WIDTH -
+         game->tetraminoes[game->core.nextTetIndex].side) /
+        2;
+    game->core.nextTetIndex = sequenceNext(&game->core.sequence);
+    game->core.gravityCounter = 0;
+    game->core.lockTimer = -1;
+    game->core.lockResets = 0;
+    game->core.lowestRow = game->curTetState->offsetRow;
+    if (checkBoardCollision(&game->core.board, game->curTetState)) {
+      gameover_fn(game);
+    } else {
+      game->core.state = fsm_move;
+      updateGhost(game);
+      updateLock(game, false);
+    }
+  }
+}
+
+/*!
+  \brief Функция смещения фигуры вниз под действием гравитации.
+
+  Фигура смещается без проверки коллизий, пока не достигнет строки падения
+  ghostRow. Если смещение невозможно, фигура лежит на опоре: запускается
+  задержка фиксации, а по ее истечении игра переходит в состояние
+  присоединения фигуры к игровому полю и помещает в очередь событие FsmLock.
+*/
+void shift_fn(Game_t* game) {
+  if (game && game->curTetState) {
+    if (game->curTetState->offsetRow >= game->core.ghostRow) {
+      if (game->core.lockTimer < 0) {
+        game->core.lockTimer = game->core.lockTicks;
+        game->core.lockAge = 0;
+      }
+      game->core.state = fsm_move;
+      if (game->core.lockTimer == 0) {
+        game->core.state = fsm_connect;
+        postEvent(game, FsmLock);
+      }
+    } else {
+      moveTetramino(game->curTetState, MoveDown);
+      game->core.state = fsm_move;
+      updateLock(game, false);
+    }
+  }
+}
+
+/*!
+  \brief Функция присоединения фигуры к игровому полю.
+
+  Фигура фиксируется на поле, заполненные строки удаляются, начисляются очки.
+  Профиль поверхности обновляется по ячейкам фигуры и удаленным строкам.
+  После присоединения игра переходит к появлению новой фигуры: событие
+  FsmClear выполняет его в том же такте. Если фигура фиксируется хотя бы
+  частично выше видимого поля, зафиксировать ее нельзя, и игра завершается.
+*/
+void connect_fn(Game_t* game) {
+  if (game && game->curTetState && game->gameInfo) {
+    static const int linesScore[TET_SIDE_MAX + 1] = {0, 100, 300, 700, 1500};
+    const TetraminoShape_t* shape = &tetraminoShapes
+        [game->curTetState->tetraminoIndex][game->curTetState->orientation];
+    int cleared = 0;
+
+    if (bbLock(&game->core.board, &game->colors, shape->rows, TET_SIDE_MAX,
+               game->curTetState->offsetRow, game->curTetState->offsetCol,
+               (int)game->curTetState->tetraminoIndex + 1)) {
+      gameover_fn(game);
+    } else {
+      bbProfileLock(&game->core.profile, shape->rows, TET_SIDE_MAX,
+                    game->curTetState->offsetRow,
+                    game->curTetState->offsetCol);
+      cleared = bbClearFullRows(&game->core.board, &game->colors,
+                                &game->core.clearedRows);
+      bbProfileClearRows(&game->core.profile, &game->core.board,
+                         &game->core.clearedRows);
+      game->core.pieces++;
+      game->core.lines += cleared;
+      game->core.lockLatency = game->core.lockAge;
+      game->core.lockTimer = -1;
+      game->core.score += linesScore[cleared];
+      if (game->core.score > game->core.highScore)
+        game->core.highScore = game->core.score;
+      updateLevel(game);
+      game->core.state = fsm_spawn;
+      postEvent(game, FsmClear);
+    }
+  }
+}
+
+/*!
+  \brief Функция завершения игры.
+*/
+void gameover_fn(Game_t* game) {
   if (game) {
-    game->curTetState->tetraminoIndex = game->nextTetIndex;
-    //Добавить задание смещения относительно центра с учетом размера фигуры.
-    game->nextTetIndex = setRandomTetraminoIndex();
-    game->state = fsm_none;
+    game->core.state = fsm_gameover;
   }
 }
 
-// void move_fn(Game_t* game);
-// void shift_fn(Game_t* game);
-// void connect_fn(Game_t* game);
-//void endGame_fn(Game_t* game);
 void action_fn(Game_t* game) {
-  if (game) return;
+  if (game) {
+    rotateTetramino(game->curTetState, RotateCwise);
+    if (checkBoardCollision(&game->core.board, game->curTetState)) {
+      rotateTetramino(game->curTetState, RotateCCwise);
+    } else {
+      updateGhost(game);
+      updateLock(game, true);
+    }
+  }
 }
 
 void left_fn(Game_t* game) {
   if (game) {
     moveTetramino(game->curTetState, MoveLeft);
-  //   if (checkCollision(game->gameInfo, game->curTetState))
-  //     moveTetramino(game->curTetState, MoveRight);
-  // }
-  } 
+    if (checkBoardCollision(&game->core.board, game->curTetState)) {
+      moveTetramino(game->curTetState, MoveRight);
+    } else {
+      updateGhost(game);
+      updateLock(game, true);
+    }
+  }
 }
 
 void right_fn(Game_t* game) {
   if (game) {
     moveTetramino(game->curTetState, MoveRight);
-  //   if (checkCollision(game->gameInfo, game->curTetState))
-  //     moveTetramino(game->curTetState, MoveLeft);
-  // }
+    if (checkBoardCollision(&game->core.board, game->curTetState)) {
+      moveTetramino(game->curTetState, MoveLeft);
+    } else {
+      updateGhost(game);
+      updateLock(game, true);
+    }
   }
 }
 
-//Функция заглушка
-void up_fn(Game_t* game) { 
-  if (game) {
-    return;
+/*!
+  \brief Функция мгновенного сброса фигуры.
+
+  Фигура переносится на строку падения ghostRow и присоединяется к полю без
+  задержки фиксации: игра переходит в состояние присоединения фигуры и
+  помещает в очередь событие FsmLock.
+*/
+void up_fn(Game_t* game) {
+  if (game && game->curTetState) {
+    game->curTetState->offsetRow = game->core.ghostRow;
+    game->core.lockAge = 0;
+    game->core.state = fsm_connect;
+    postEvent(game, FsmLock);
   }
 }
 
 void down_fn(Game_t* game) {
-  if (game) {
+  if (game && game->curTetState &&
+      game->curTetState->offsetRow < game->core.ghostRow) {
     moveTetramino(game->curTetState, MoveDown);
-    // if (checkCollision(game->gameInfo, game->curTetState))
-    //   moveTetramino(game->curTetState, MoveUp);
-    //Добавить вызовы функций объединения с полем, Функцию передачи индекса
-    //следующей фигуры в текущее состояние, функцию генрацию индекса фигуры,.
+    updateLock(game, true);
   }
 }
 
+/*!
+  \brief Таблица гравитации по уровням в ячейках за такт.
+
+  Время смещения на одну ячейку на уровне L равно (0.8 - 0.007 (L - 1))^(L - 1)
+  секунд. С 15 уровня фигура смещается больше чем на одну ячейку за такт, на
+  последнем уровне действует гравитация 20G.
+*/
+static const int32_t gravityTable[GAME_SPEED_MAX] = {
+    GAME_GRAVITY_US(1000000), GAME_GRAVITY_US(793000), GAME_GRAVITY_US(617796),
+    GAME_GRAVITY_US(472729),  GAME_GRAVITY_US(355197), GAME_GRAVITY_US(262004),
+    GAME_GRAVITY_US(189677),  GAME_GRAVITY_US(134735), GAME_GRAVITY_US(93882),
+    GAME_GRAVITY_US(64152),   GAME_GRAVITY_US(42976),  GAME_GRAVITY_US(28218),
+    GAME_GRAVITY_US(18153),   GAME_GRAVITY_US(11439),  GAME_GRAVITY_US(7059),
+    GAME_GRAVITY_US(4264),    GAME_GRAVITY_US(2520),   GAME_GRAVITY_US(1457),
+    GAME_GRAVITY_US(824),     GAME_GRAVITY_20G};
+
+/*!
+  \ingroup Score_operations Функции обработки результата игры
+  \brief Функция пересчета уровня и гравитации по набранным очкам.
+  \param [in,out] game Указатель на структуру Game_t.
+
+  Уровень повышается каждые GAME_LEVEL_SCORE очков, но не выше GAME_SPEED_MAX.
+  Гравитация уровня выбирается из таблицы gravityTable.
+*/
+void updateLevel(Game_t* game) {
+  if (game && game->gameInfo) {
+    int level = 1 + game->core.score / GAME_LEVEL_SCORE;
+    if (level > GAME_SPEED_MAX) level = GAME_SPEED_MAX;
+    game->core.level = (int8_t)level;
+    game->core.speed = (int8_t)level;
+    game->core.gravity = gravityTable[level - 1];
+  }
+}
+
+/*!
+  \brief Функция автоповтора смещения удерживаемой фигуры.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] move Функция смещения (left_fn(), right_fn(), down_fn()).
+  \param [in,out] timer Счетчик тактов до автоповтора.
+
+  По истечении счетчика фигура смещается, и счетчик взводится на arrTicks
+  тактов. При arrTicks = 0 фигура смещается до препятствия в каждом такте.
+*/
+static void autoShift(Game_t* game, actfunc move, int16_t* timer) {
+  if (*timer > 0) --*timer;
+  if (*timer == 0) {
+    if (game->core.arrTicks > 0) {
+      move(game);
+      *timer = game->core.arrTicks;
+    } else {
+      TetraminoState_t prev;
+      do {
+        prev = *game->curTetState;
+        move(game);
+      } while (prev.offsetCol != game->curTetState->offsetCol ||
+               prev.offsetRow != game->curTetState->offsetRow);
+    }
+  }
+}
+
+/*!
+  \brief Функция такта в состоянии перемещения фигуры.
+  \param [in,out] game Указатель на структуру Game_t.
+
+  Такт выполняет автоповтор смещений удерживаемых клавиш и добавляет
+  гравитацию уровня к накопленному смещению. Фигура смещается вниз на каждую
+  накопленную целую ячейку, пока не коснется опоры. Лежащая фигура не
+  смещается гравитацией, а такт уменьшает ее задержку фиксации; по истечении
+  задержки игра переходит в состояние присоединения фигуры и помещает в
+  очередь событие FsmLock.
+*/
+void move_fn(Game_t* game) {
+  if (game && game->curTetState) {
+    if (game->core.lockTimer > 0) {
+      game->core.lockTimer--;
+      game->core.lockAge++;
+    }
+    if (game->core.shiftAction == Left)
+      autoShift(game, left_fn, &game->core.shiftTimer);
+    else if (game->core.shiftAction == Right)
+      autoShift(game, right_fn, &game->core.shiftTimer);
+    if (game->core.heldKeys & HOLD_BIT(Down))
+      autoShift(game, down_fn, &game->core.dropTimer);
+    if (game->core.lockTimer < 0) {
+      game->core.gravityCounter += game->core.gravity;
+      while (game->core.state == fsm_move && game->core.lockTimer < 0 &&
+             game->core.gravityCounter >= GAME_GRAVITY_ONE) {
+        game->core.gravityCounter -= GAME_GRAVITY_ONE;
+        shift_fn(game);
+      }
+      if (game->core.lockTimer >= 0) game->core.gravityCounter = 0;
+    }
+    if (game->core.state == fsm_move && game->core.lockTimer == 0) {
+      game->core.state = fsm_connect;
+      postEvent(game, FsmLock);
+    }
+  }
+}
+
+/*!
+  \ingroup Headless_engine Функции игрового движка без интерфейса
+  \brief Функция выполнения одного логического такта игры.
+  \param [in,out] game Указатель на структуру Game_t.
+
+  Событие FsmTick помещается в очередь после накопленных действий
+  пользователя и обрабатывается по таблице переходов вместе с порожденными им
+  событиями: в состоянии перемещения фигуры - move_fn(), при фиксации фигуры -
+  connect_fn() и появление следующей фигуры в том же такте.
+*/
+static void tickGame(Game_t* game) {
+  game->core.tick++;
+  if (postEvent(game, FsmTick)) {
+    dispatchEvents(game);
+    postEvent(game, FsmTick);
+  }
+  dispatchEvents(game);
+}
+
+/*!
+  \ingroup Headless_engine Функции игрового движка без интерфейса
+  \brief Функция продвижения игры на заданное количество логических тактов.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in] action Действие пользователя, выполняемое перед первым тактом.
+  \param [in] ticks Количество логических тактов.
+  \return Состояние игры после выполнения тактов.
+
+  Функция обрабатывает накопленные события и действие пользователя по таблице
+  переходов, а затем продвигает гравитацию, присоединение фигур, удаление строк и
+  появление новых фигур. Функция не использует терминал и реальное время: один
+  такт соответствует GAME_SPEED_DELAY миллисекундам игрового времени. В
+  состояниях, в которых игра не развивается (пауза, завершение), оставшиеся
+  такты учитываются в счетчике без выполнения.
+*/
+fsm_state_t tetris_step(Game_t* game, UserAction_t action, int ticks) {
+  fsm_state_t state = fsm_none;
+
+  if (game) {
+    userInputCtx(game, action, false);
+    for (int i = 0; i < ticks; i++) {
+      if (game->core.state == fsm_none || game->core.state == fsm_pause ||
+          game->core.state == fsm_gameover || game->core.state == fsm_exit) {
+        game->core.tick += (uint64_t)(ticks - i);
+        break;
+      }
+      tickGame(game);
+    }
+    state = game->core.state;
+  }
+
+  return state;
+}
+
+/*!
+  \ingroup Headless_engine Функции игрового движка без интерфейса
+  \brief Функция определения количества тактов до ближайшего события игры.
+  \param [in] game Указатель на структуру Game_t.
+  \return Количество логических тактов, которые можно выполнить без действий
+  пользователя до ближайшего изменения поля или фигуры, или -1, если игра не
+  развивается без действий пользователя (меню, пауза, завершение).
+
+  Функция позволяет интерфейсу ожидать ввода пользователя с тайм-аутом до
+  следующего смещения фигуры (гравитацией или автоповтором удерживаемой
+  клавиши) или ее фиксации, а не опрашивать ввод на каждом такте.
+*/
+int ticksUntilEvent(const Game_t* game) {
+  int ticks = -1;
+
+  if (game && game->core.state == fsm_move &&
+      (game->core.lockTimer >= 0 || game->core.gravity > 0)) {
+    if (game->core.lockTimer >= 0)
+      ticks = game->core.lockTimer;
+    else
+      ticks = (GAME_GRAVITY_ONE - game->core.gravityCounter +
+               game->core.gravity - 1) /
+              game->core.gravity;
+    if (game->core.shiftAction != None && game->core.shiftTimer < ticks)
+      ticks = game->core.shiftTimer;
+    if ((game->core.heldKeys & HOLD_BIT(Down)) && game->core.dropTimer < ticks)
+      ticks = game->core.dropTimer;
+    if (ticks < 1) ticks = 1;
+  } else if (game && (game->core.state == fsm_start ||
+                      game->core.state == fsm_spawn ||
+                      game->core.state == fsm_connect)) {
+    ticks = 1;
+  }
+
+  return ticks;
+}
+
 /*!
   \ingroup Score_operations Функции обработки результата игры
   \brief Функция считывания из файла значения лучшего результата
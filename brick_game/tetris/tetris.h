@@ -15,13 +15,11 @@
 #define TETRIS_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
+#include "bitboard.h"
 #include "gamepref.h"
-
-/*!
-  \brief Макрос размерности массива фигур (тетрамино)
-*/
-#define TET_COUNT 7
+#include "tetrand.h"
 
 /*!
   \brief Перечисление значения флага состояния хранения адреса локатора
@@ -34,7 +32,6 @@ typedef enum fsm_state_t {
   fsm_pause,
   fsm_spawn,
   fsm_move,
-  fsm_shift,
   fsm_connect,
   fsm_gameover,
   fsm_exit
@@ -91,6 +88,62 @@ typedef struct Tetramino_t {
                    ///< квадрата описывающего фигуру.
 } Tetramino_t;
 
+/*!
+  \brief Макрос максимального размера стороны квадрата, описывающего фигуру.
+*/
+#define TET_SIDE_MAX 4
+
+_Static_assert(TET_SIDE_MAX - 1 <= BB_PAD,
+               "сторожевая рамка битового поля тоньше фигуры");
+
+/*!
+  \brief Макрос количества ячеек, из которых состоит фигура.
+*/
+#define TET_CELLS 4
+
+/*!
+  \brief Макрос количества ориентаций фигуры.
+*/
+#define TET_ORIENT_COUNT 4
+
+/*!
+  \brief Значение ячейки поля, занятой проекцией текущей фигуры на опору.
+
+  Проекция выгружается функцией exportGhost() только в пустые ячейки поля.
+*/
+#define TET_GHOST_CELL (-1)
+
+/*!
+  \brief Структура координат ячейки фигуры в квадрате, описывающем фигуру.
+*/
+typedef struct TetCell_t {
+  int8_t row;  ///< Смещение ячейки по вертикали.
+  int8_t col;  ///< Смещение ячейки по горизонтали.
+} TetCell_t;
+
+/*!
+  \brief Структура предвычисленного описания фигуры в одной ориентации.
+
+  Структура содержит две формы одной и той же фигуры: маски строк для проверки
+  коллизий с битовым игровым полем и список ячеек для отрисовки. Все значения
+  вычислены заранее и хранятся в таблице tetraminoShapes.
+*/
+typedef struct TetraminoShape_t {
+  bbrow_t rows[TET_SIDE_MAX];  ///< Маски строк фигуры (бит j - столбец j).
+  TetCell_t cells[TET_CELLS];  ///< Координаты занятых ячеек фигуры.
+  int8_t top;     ///< Индекс первой непустой строки.
+  int8_t bottom;  ///< Индекс последней непустой строки.
+  int8_t left;    ///< Индекс первого непустого столбца.
+  int8_t right;   ///< Индекс последнего непустого столбца.
+} TetraminoShape_t;
+
+/*!
+  \brief Таблица описаний всех фигур во всех ориентациях.
+
+  Индексируется значениями tetraminoIndex_t и tetOrientation_t.
+*/
+extern const TetraminoShape_t tetraminoShapes[TET_COUNT][TET_ORIENT_COUNT];
+
 /*!
   \brief Структура описания состояния текущей фигуры тетрамино относительно
   игрового поля.
@@ -135,21 +188,123 @@ typedef struct GameInfo_t {
   int pause;  ///< Целочисленное значение индикации паузы в игре.
 } GameInfo_t;
 
+/*!
+  \brief Размер очереди событий конечного автомата экземпляра игры.
+*/
+#define GAME_EVENT_QUEUE 16
+
+/*!
+  \brief Структура изменяемого состояния игры.
+
+  Все поля, изменяемые при обработке тактов и событий, собраны в одном
+  плоском блоке без указателей, который расположен в начале Game_t и
+  копируется одним присваиванием (см. GameSnapshot_t). Поля упорядочены по
+  убыванию выравнивания, чтобы блок не содержал внутренних пропусков.
+  Цветовая плоскость поля в блок не входит: вместе с масками строк она не
+  помещается в 256 байт и нужна только для отрисовки.
+*/
+typedef struct GameCore_t {
+  uint64_t tick;  ///< Количество логических тактов, прошедших с создания
+                  ///< экземпляра игры.
+  uint64_t seed;  ///< Зерно, которым инициализирован генератор sequence.
+  BoardRowSet_t clearedRows;  ///< Строки, удаленные при последней фиксации
+                             ///< фигуры (для подсчета очков и анимации).
+  TetSequence_t sequence;  ///< Генератор последовательности фигур.
+  TetraminoState_t piece;  ///< Состояние текущей фигуры, на которое указывает
+                           ///< curTetState.
+  int32_t score;      ///< Количество очков.
+  int32_t highScore;  ///< Лучший результат.
+  int32_t lines;   ///< Количество удаленных строк с начала игры.
+  int32_t pieces;  ///< Количество зафиксированных фигур с начала игры.
+  int32_t gravity;  ///< Гравитация в ячейках за такт (GAME_GRAVITY_ONE -
+                    ///< одна ячейка).
+  int32_t gravityCounter;  ///< Накопленное смещение фигуры вниз в единицах
+                           ///< гравитации.
+  int32_t lockAge;  ///< Тактов с момента касания опоры текущей фигурой.
+  int32_t lockLatency;  ///< Тактов от касания опоры до фиксации последней
+                        ///< присоединенной фигуры.
+  BitBoard_t board;  ///< Битовое представление игрового поля, по которому
+                     ///< выполняются проверки коллизий и фиксация фигур.
+  BoardProfile_t profile;  ///< Высоты столбцов, дыры и заполненность строк
+                           ///< поля board, обновляемые при каждой фиксации.
+  int16_t dasTicks;  ///< Задержка автоповтора удерживаемой клавиши в тактах.
+  int16_t arrTicks;  ///< Интервал автоповтора в тактах, 0 - смещение до
+                     ///< препятствия.
+  int16_t shiftTimer;  ///< Тактов до автоповтора смещения по горизонтали.
+  int16_t dropTimer;   ///< Тактов до автоповтора смещения вниз.
+  int16_t lockTicks;  ///< Задержка фиксации лежащей фигуры в тактах.
+  int16_t lockResetMax;  ///< Допустимое количество перезапусков задержки.
+  int16_t lockTimer;  ///< Тактов до фиксации лежащей фигуры, -1 - фигура не
+                      ///< лежит на опоре.
+  int16_t lockResets;  ///< Количество выполненных перезапусков задержки.
+  uint16_t heldKeys;  ///< Маска удерживаемых клавиш (HOLD_BIT()).
+  int8_t level;  ///< Уровень игры.
+  int8_t speed;  ///< Скорость игры.
+  int8_t pause;  ///< Признак паузы.
+  int8_t nextTetIndex;  ///< Индекс следующей фигуры в массиве.
+  int8_t shiftAction;  ///< Удерживаемое смещение по горизонтали (Left, Right)
+                       ///< или None.
+  int8_t lowestRow;  ///< Наибольшее смещение фигуры по вертикали.
+  int8_t ghostRow;  ///< Смещение по вертикали, на котором текущая фигура
+                    ///< ляжет на опору; пересчитывается при смене положения
+                    ///< фигуры.
+  uint8_t state;  ///< Состояние конечного автомата (fsm_state_t).
+  uint8_t pausedState;  ///< Состояние, сохраненное на время паузы.
+  uint8_t modified;  ///< Признак изменения состояния.
+  uint8_t attached;  ///< Признак подключенных gameInfo и curTetState (игра
+                     ///< начата).
+  uint8_t eventHead;  ///< Индекс первого необработанного события.
+  uint8_t eventCount;  ///< Количество необработанных событий.
+  uint8_t events[GAME_EVENT_QUEUE];  ///< Очередь необработанных событий
+                                     ///< конечного автомата.
+} GameCore_t;
+
 /*!
   \brief Базовая структура игры.
+
+  Изменяемое состояние игры хранится в блоке core, остальные поля - указатели
+  и данные, которые не меняются в ходе игры или нужны только для отрисовки.
 */
 typedef struct Game_t {
+  GameCore_t core;  ///< Изменяемое состояние игры.
   GameInfo_t* gameInfo;  ///< Указатель на область памяти где хранится структура
-                         ///< состояния игры в моменте времени.
-  Tetramino_t*
+                         ///< состояния игры в моменте времени. Поля структуры
+                         ///< заполняются из core функцией
+                         ///< updateCurrentStateCtx().
+  const Tetramino_t*
       tetraminoes;  ///< Указатель на массив структур описания фигур тетрамино.
-  TetraminoState_t* curTetState;  ///< Указатель на область памяти где хранится
-                                  ///< состояние текущей фигуры.
-  int nextTetIndex;  ///< Индекс следующей фигуры в массиве.
-  fsm_state_t state;  ///< Действие выполненное пользователем.
-  bool modified;
+  TetraminoState_t* curTetState;  ///< Указатель на core.piece или NULL, если
+                                  ///< игра не начата.
+  struct ReplayWriter_t* replay;  ///< Запись повтора, в которую передаются
+                                 ///< действия пользователя, или NULL.
+  bool ownsArena;  ///< Признак того, что область памяти игры выделена при
+                   ///< создании и освобождается функцией destroyGame().
+  BoardColors_t colors;  ///< Цвета ячеек поля core.board для отрисовки.
 } Game_t;
 
+/*!
+  \brief Выравнивание области памяти игры, равное размеру строки кэша.
+*/
+#define GAME_ARENA_ALIGN 64
+
+/*!
+  \brief Структура области памяти экземпляра игры.
+
+  Область содержит структуру Game_t и все подчиненные ей структуры: состояние
+  игры GameInfo_t с массивами ячеек игрового поля и следующей фигуры.
+  Состояние текущей фигуры хранится в Game_t::core. Структура Game_t
+  расположена в начале области, поэтому указатель на игру является и
+  указателем на ее область памяти.
+*/
+typedef struct GameArena_t {
+  _Alignas(GAME_ARENA_ALIGN) Game_t game;  ///< Структура игры.
+  GameInfo_t info;  ///< Состояние игры, на которое указывает game.gameInfo.
+  int* fieldRows[GAME_BOARD_HEIGHT];  ///< Строки массива info.field.
+  int* nextRows[TET_SIDE_MAX];  ///< Строки массива info.next.
+  int fieldCells[GAME_BOARD_HEIGHT * GAME_BOARD_WIDTH];  ///< Ячейки поля.
+  int nextCells[TET_SIDE_MAX * TET_SIDE_MAX];  ///< Ячейки следующей фигуры.
+} GameArena_t;
+
 typedef enum UserAction_t {
   None,
   Start,
@@ -162,6 +317,29 @@ typedef enum UserAction_t {
   Action
 } UserAction_t;
 
+/*!
+  \brief Перечисление внутренних событий конечного автомата.
+
+  Значения продолжают нумерацию UserAction_t, поэтому действия пользователя и
+  внутренние события образуют общее множество событий автомата.
+*/
+typedef enum fsmEvent_t {
+  FsmTick = Action + 1,  ///< Логический такт игры.
+  FsmLock,  ///< Истечение задержки фиксации фигуры.
+  FsmClear,  ///< Завершение удаления заполненных строк.
+  FsmEventCount  ///< Количество событий автомата.
+} fsmEvent_t;
+
+/*!
+  \brief Количество состояний конечного автомата.
+*/
+#define FSM_STATE_COUNT (fsm_exit + 1)
+
+/*!
+  \brief Макрос бита действия пользователя в маске удерживаемых клавиш.
+*/
+#define HOLD_BIT(action) (1u << (unsigned)(action))
+
 /*!
   \brief Перечисление индексов направления вращения фигуры.
 */
@@ -186,12 +364,17 @@ typedef struct game_locator {
 */
 // int getHighScore();
 // void saveHighScore(const int hscore);
+void updateLevel(Game_t* game);
 
 /*!
   \defgroup Data_Structure_management Функции управления структурами данных
   \brief Функции создают, очищают и удаляют игровые структуры
 */
 Game_t* createGame();
+Game_t* createGameCtx();
+Game_t* createGameIn(void* memory, size_t size);
+Game_t* relocateGame(Game_t* game, void* memory, size_t size);
+int attachGameInfo(Game_t* game);
 void clearGame(Game_t* game);
 void destroyGame(Game_t* game);
 GameInfo_t* createGameInfo();
@@ -214,16 +397,33 @@ Game_t* locateGame(Game_t* game);
 typedef void (*actfunc)(Game_t*);
 
 void userInput(UserAction_t action, bool hold);
+void userInputCtx(Game_t* game, UserAction_t action, bool hold);
+
+/*!
+  \defgroup Fsm_events Функции очереди событий конечного автомата
+  \brief Функции накопления и обработки событий конечного автомата.
+
+  \details Действия пользователя и внутренние события (такт, фиксация фигуры,
+  удаление строк) помещаются в очередь экземпляра игры и обрабатываются за
+  один проход по таблице переходов.
+*/
+int postUserInput(Game_t* game, UserAction_t action, bool hold);
+int postEvent(Game_t* game, int event);
+void dispatchEvents(Game_t* game);
 
 /*!
   \defgroup Data_manipulation Функции чтения и изменения данных
   \brief Функции предназначены для получения и изменения данных
 */
-Tetramino_t* fillTatraminoes();
-void destroyTetraminoes();
+const Tetramino_t* fillTatraminoes();
+const TetraminoShape_t* getTetraminoShape(tetraminoIndex_t index,
+                                          tetOrientation_t orientation);
 int getCellValue(const int** gameboard, int col, int row);
 int setCellValue(int** gameboard, int col, int row, int val);
 int setRandomTetraminoIndex();
+void seedGame(Game_t* game, uint64_t seed, tetSequencePolicy_t policy);
+int setAutoShift(Game_t* game, int dasTicks, int arrTicks);
+int setLockDelay(Game_t* game, int lockTicks, int lockResets);
 
 /*!
   \brief Функция обработки действия "Вращение фигуры"
@@ -278,6 +478,8 @@ int moveTetramino(TetraminoState_t* tetState,
   TetraminoState_t.
 */
 int checkCollision(GameInfo_t* gameinfo, TetraminoState_t* tetState);
+int checkBoardCollision(const BitBoard_t* board,
+                        const TetraminoState_t* tetState);
 
 /*!
   \defgroup Functions_getting_data_structure_for_rendering Функции получения
@@ -288,11 +490,27 @@ int checkCollision(GameInfo_t* gameinfo, TetraminoState_t* tetState);
   \details Функции получают и возвращают структуру данных game_info_t
 */
 GameInfo_t updateCurrentState();
+GameInfo_t updateCurrentStateCtx(Game_t* game);
+void exportGameField(const Game_t* game, int** field, int** next);
+void exportGhost(const Game_t* game, int** field);
+int getGhostRow(const Game_t* game);
+void drawTetramino(int** field, const int rows, const int cols,
+                   const TetraminoState_t* tetState);
+
+/*!
+  \defgroup Headless_engine Функции игрового движка без интерфейса
+  \brief Функции продвижения игры по логическим тактам.
+
+  \details Функции не используют терминал и реальное время, поэтому игра может
+  выполняться с максимальной скоростью.
+*/
+fsm_state_t tetris_step(Game_t* game, UserAction_t action, int ticks);
+int ticksUntilEvent(const Game_t* game);
 
 /*!
-  \brief Функция вызова
+  \brief Функция выбора обработчика события по таблице переходов.
 */
-actfunc fsm(fsm_state_t state, UserAction_t userAction);
+actfunc fsm(fsm_state_t state, int event);
 void start_fn(Game_t* game);
 void pause_fn(Game_t* game);
 void spawn_fn(Game_t* game);
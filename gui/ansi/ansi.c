@@ -0,0 +1,250 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ansi.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// frame being composed, emitted by frame_flush with one write()
+static struct {
+  char data[ANSI_FRAME_SIZE];
+  size_t len;
+  int color;  // cell value whose colors are currently set, -1 - unknown,
+              // ANSI_CELL_VALUES - ghost cell
+} frame;
+
+// last frame drawn by ansi_print_field, used to emit only changed rows
+static struct {
+  int field[GAME_BOARD_HEIGHT][GAME_BOARD_WIDTH];
+  int next[TET_SIDE_MAX][TET_SIDE_MAX];
+  int score;
+  int high_score;
+  bool valid;
+} shown;
+
+static struct termios saved_tty;
+static bool tty_raw = false;
+static bool truecolor = false;
+
+// figure colors in the same order as the ncurses color pairs
+static const unsigned char cell_rgb[ANSI_CELL_VALUES][3] = {
+    {0, 0, 0},       {220, 50, 47},  {133, 153, 0},   {38, 139, 210},
+    {181, 137, 0},   {211, 54, 130}, {42, 161, 152},  {238, 232, 213}};
+static const int cell_sgr[ANSI_CELL_VALUES] = {40, 41, 42, 44, 43, 45, 46, 47};
+
+static void frame_printf(const char *format, ...) {
+  va_list args;
+  int n = 0;
+
+  if (frame.len >= sizeof(frame.data)) return;
+  va_start(args, format);
+  n = vsnprintf(frame.data + frame.len, sizeof(frame.data) - frame.len, format,
+                args);
+  va_end(args);
+  if (n > 0) frame.len += (size_t)n;
+  if (frame.len > sizeof(frame.data)) frame.len = sizeof(frame.data);
+}
+
+static void frame_begin(void) {
+  frame.len = 0;
+  frame.color = -1;
+  frame_printf("\033[?2026h");
+}
+
+// finishes the synchronized update and sends the whole frame to the tty
+static void frame_flush(void) {
+  size_t done = 0;
+
+  frame_printf("\033[0m\033[?2026l");
+  while (done < frame.len) {
+    ssize_t n = write(STDOUT_FILENO, frame.data + done, frame.len - done);
+    if (n <= 0) break;
+    done += (size_t)n;
+  }
+  frame.len = 0;
+}
+
+static void frame_border_color(void) {
+  frame_printf("\033[0;34;40m");
+  frame.color = -1;
+}
+
+static void frame_box(int row, int col, int height, int width,
+                      const char *title) {
+  frame_printf("\033[%d;%dH┌", row, col);
+  for (int i = 2; i < width; i++) frame_printf("─");
+  frame_printf("┐");
+  for (int i = 1; i < height - 1; i++)
+    frame_printf("\033[%d;%dH│\033[%d;%dH│", row + i, col, row + i,
+                 col + width - 1);
+  frame_printf("\033[%d;%dH└", row + height - 1, col);
+  for (int i = 2; i < width; i++) frame_printf("─");
+  frame_printf("┘");
+  if (title) frame_printf("\033[%d;%dH%s", row, col + 1, title);
+}
+
+static void frame_cells(int row, int col, const int *cells, int n) {
+  frame_printf("\033[%d;%dH", row, col);
+  for (int j = 0; j < n; j++) {
+    int v = (cells[j] > 0 && cells[j] < ANSI_CELL_VALUES) ? cells[j] : 0;
+    if (cells[j] == TET_GHOST_CELL) v = ANSI_CELL_VALUES;
+    if (v != frame.color) {
+      if (!v)
+        frame_printf("\033[0;40m");
+      else if (v == ANSI_CELL_VALUES)
+        frame_printf("\033[0;34;40m");
+      else if (truecolor)
+        frame_printf("\033[38;2;0;0;0;48;2;%d;%d;%dm", cell_rgb[v][0],
+                     cell_rgb[v][1], cell_rgb[v][2]);
+      else
+        frame_printf("\033[30;%dm", cell_sgr[v]);
+      frame.color = v;
+    }
+    frame_printf(!v ? "  " : v == ANSI_CELL_VALUES ? "::" : "[]");
+  }
+}
+
+// raw mode, alternate screen, hidden cursor
+int ansi_init(void) {
+  int err = 1;
+  const char *colorterm = getenv("COLORTERM");
+
+  if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved_tty) == 0) {
+    struct termios raw = saved_tty;
+    raw.c_iflag &= ~(tcflag_t)(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+    raw.c_oflag &= ~(tcflag_t)OPOST;
+    raw.c_cflag |= CS8;
+    raw.c_lflag &= ~(tcflag_t)(ECHO | ICANON | IEXTEN | ISIG);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0) {
+      tty_raw = true;
+      err = 0;
+    }
+  }
+  truecolor = colorterm && (!strcmp(colorterm, "truecolor") ||
+                            !strcmp(colorterm, "24bit"));
+  if (!err) {
+    frame_begin();
+    frame_printf("\033[?1049h\033[?25l\033[0m\033[2J");
+    frame_flush();
+  }
+  ansi_invalidate_field();
+
+  return err;
+}
+
+void ansi_deinit(void) {
+  frame_begin();
+  frame_printf("\033[0m\033[2J\033[?25h\033[?1049l");
+  frame_flush();
+  if (tty_raw) tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_tty);
+  tty_raw = false;
+}
+
+void ansi_show_menu(void) {
+  frame_begin();
+  frame_printf("\033[0;34;40m\033[2J");
+  frame_printf("\033[8;6HPRESS \"ESC\"  TO EXIT");
+  frame_printf("\033[11;6HPRESS \"ENTER\" TO START GAME");
+  frame_printf("\033[15;27H|GOOD*|\033[16;27H|*LUCK|");
+  frame_flush();
+}
+
+// static chrome of the game screen, drawn when the screen is shown
+void ansi_show_board(void) {
+  frame_begin();
+  frame_border_color();
+  frame_printf("\033[2J");
+  frame_box(ANSI_BOARD_ROW, ANSI_BOARD_COL, ANSI_BOARD_HEIGHT,
+            ANSI_BOARD_WIDTH, NULL);
+  frame_box(ANSI_BOARD_ROW, ANSI_PANEL_COL, ANSI_BOARD_HEIGHT,
+            ANSI_PANEL_WIDTH, NULL);
+  frame_box(ANSI_BOARD_ROW + 1, ANSI_PANEL_COL + 1, TET_SIDE_MAX + 2,
+            ANSI_PANEL_WIDTH - 2, "-NEXT-FIGURE-");
+  frame_box(ANSI_BOARD_ROW + TET_SIDE_MAX + 4, ANSI_PANEL_COL + 1, 5,
+            ANSI_PANEL_WIDTH - 2, "-YOUR-SCORE-");
+  frame_printf("\033[%d;%dH├-HIGH-SCORE-┤",
+               ANSI_BOARD_ROW + TET_SIDE_MAX + 6, ANSI_PANEL_COL + 1);
+  frame_box(ANSI_HELP_ROW, ANSI_BOARD_COL, ANSI_HELP_HEIGHT,
+            ANSI_BOARD_WIDTH + ANSI_PANEL_WIDTH, NULL);
+  frame_printf("\033[%d;%dH ROTATING - \"A\"", ANSI_HELP_ROW + 1,
+               ANSI_BOARD_COL + 1);
+  frame_printf("\033[%d;%dH MOVE DOWN/DROP - DOWN/UP KEY", ANSI_HELP_ROW + 2,
+               ANSI_BOARD_COL + 1);
+  frame_printf("\033[%d;%dH MOVE LEFT/RIGHT - L/R ARROW KEY", ANSI_HELP_ROW + 3,
+               ANSI_BOARD_COL + 1);
+  frame_printf("\033[%d;%dH PAUSE - \"P\"", ANSI_HELP_ROW + 4,
+               ANSI_BOARD_COL + 1);
+  frame_flush();
+  ansi_invalidate_field();
+}
+
+// pause message is shown inside the playfield
+void ansi_show_pause(void) {
+  frame_begin();
+  frame_border_color();
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    frame_printf("\033[%d;%dH%*s", ANSI_BOARD_ROW + 1 + i, ANSI_BOARD_COL + 1,
+                 GAME_BOARD_WIDTH * 2, "");
+  frame_printf("\033[%d;%dHPRESS \"ENTER\"", ANSI_BOARD_ROW + 5,
+               ANSI_BOARD_COL + 4);
+  frame_printf("\033[%d;%dHTO  CONTINUE", ANSI_BOARD_ROW + 6,
+               ANSI_BOARD_COL + 4);
+  frame_printf("\033[%d;%dHPRESS \"ESC\"", ANSI_BOARD_ROW + 11,
+               ANSI_BOARD_COL + 5);
+  frame_printf("\033[%d;%dHTO  EXIT", ANSI_BOARD_ROW + 12, ANSI_BOARD_COL + 6);
+  frame_flush();
+  ansi_invalidate_field();
+}
+
+void ansi_invalidate_field(void) { shown.valid = false; }
+
+// emits the changed rows of the field and next figure and the changed scores
+// as one synchronized frame
+void ansi_print_field(const GameInfo_t *info) {
+  bool changed = false;
+
+  if (!info || !info->field) return;
+  frame_begin();
+
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    if (!shown.valid ||
+        memcmp(shown.field[i], info->field[i], sizeof(shown.field[i]))) {
+      frame_cells(ANSI_BOARD_ROW + 1 + i, ANSI_BOARD_COL + 1, info->field[i],
+                  GAME_BOARD_WIDTH);
+      memcpy(shown.field[i], info->field[i], sizeof(shown.field[i]));
+      changed = true;
+    }
+
+  for (int i = 0; info->next && i < TET_SIDE_MAX; i++)
+    if (!shown.valid ||
+        memcmp(shown.next[i], info->next[i], sizeof(shown.next[i]))) {
+      frame_cells(ANSI_BOARD_ROW + 2 + i, ANSI_PANEL_COL + 4, info->next[i],
+                  TET_SIDE_MAX);
+      memcpy(shown.next[i], info->next[i], sizeof(shown.next[i]));
+      changed = true;
+    }
+
+  if (!shown.valid || shown.score != info->score ||
+      shown.high_score != info->high_score) {
+    frame_border_color();
+    frame_printf("\033[%d;%dH %-11d", ANSI_BOARD_ROW + TET_SIDE_MAX + 5,
+                 ANSI_PANEL_COL + 2, info->score);
+    frame_printf("\033[%d;%dH %-11d", ANSI_BOARD_ROW + TET_SIDE_MAX + 7,
+                 ANSI_PANEL_COL + 2, info->high_score);
+    changed = true;
+  }
+  shown.score = info->score;
+  shown.high_score = info->high_score;
+  shown.valid = true;
+
+  if (changed)
+    frame_flush();
+  else
+    frame.len = 0;
+}
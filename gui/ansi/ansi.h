@@ -0,0 +1,37 @@
+#ifndef ANSI_H
+#define ANSI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../brick_game/tetris/tetris.h"
+
+// Terminal frontend without ncurses: the tty is switched to raw mode, every
+// frame is composed into one buffer of escape sequences and emitted with a
+// single write(), wrapped into synchronized output (CSI ?2026h / ?2026l)
+
+// Frame buffer size, enough for a full redraw of the game screen
+#define ANSI_FRAME_SIZE 16384
+
+// Screen layout, same as the ncurses frontend (1-based terminal coordinates)
+#define ANSI_BOARD_ROW 1
+#define ANSI_BOARD_COL 1
+#define ANSI_BOARD_HEIGHT (GAME_BOARD_HEIGHT + 2)
+#define ANSI_BOARD_WIDTH (GAME_BOARD_WIDTH * 2 + 2)
+#define ANSI_PANEL_COL (ANSI_BOARD_COL + ANSI_BOARD_WIDTH)
+#define ANSI_PANEL_WIDTH 16
+#define ANSI_HELP_ROW (ANSI_BOARD_ROW + ANSI_BOARD_HEIGHT)
+#define ANSI_HELP_HEIGHT 6
+
+// Number of cell values: empty cell and one color per figure
+#define ANSI_CELL_VALUES (TET_COUNT + 1)
+
+int ansi_init(void);
+void ansi_deinit(void);
+void ansi_show_menu(void);
+void ansi_show_board(void);
+void ansi_show_pause(void);
+void ansi_print_field(const GameInfo_t *info);
+void ansi_invalidate_field(void);
+
+#endif
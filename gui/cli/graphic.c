@@ -1,5 +1,29 @@
 #include "graphic.h"
 
+#include <string.h>
+
+// last frame drawn by print_field, used to emit only changed cells
+static struct {
+  int field[GAME_BOARD_HEIGHT][GAME_BOARD_WIDTH];
+  int next[TET_SIDE_MAX][TET_SIDE_MAX];
+  int score;
+  int high_score;
+  bool valid;
+} shown;
+
+// persistent windows of the game screen, borders are drawn once on creation
+static struct {
+  WINDOW *board;
+  WINDOW *panel;
+  WINDOW *next;
+  WINDOW *score;
+  WINDOW *help;
+} wins;
+
+// two-character glyph of every cell value with its color pair and of the
+// ghost cell (last entry), built once the color pairs are initialized
+static chtype cell_glyphs[CELL_VALUES + 1][2];
+
 //graphic initialization
 void initGraphics(void) {
   initscr();
@@ -9,6 +33,8 @@ void initGraphics(void) {
   curs_set(0);
   nodelay(stdscr, TRUE);
   scrollok(stdscr, TRUE);
+  // input is read from stdin directly, do not poll it while refreshing
+  typeahead(-1);
 }
 
 //color scheme initialization
@@ -26,13 +52,15 @@ int enableColorMode() {
       init_pair(8, COLOR_BLACK, COLOR_WHITE);
     }
   }
+  init_cell_glyphs();
 
   return code;
 }
 
 //graphic deinitialization
-void deinitGraphics(void) { 
-  endwin(); 
+void deinitGraphics(void) {
+  destroy_windows();
+  endwin();
 }
 
 void showSpalshScreen() {
@@ -54,6 +82,7 @@ void showMainMenu() {
 }
 
 void clear_field(int y, int x) {
+  invalidate_field();
   attrset(COLOR_PAIR(1));
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x * 2; j++) {
@@ -63,144 +92,153 @@ void clear_field(int y, int x) {
   refresh();
 }
 
-void showGameBoard() {
-  clear_field(GAME_BOARD_HEIGHT, GAME_BOARD_WIDTH * 2);
-  print_corners(20, 10);
-  print_field_boards(20, 10);
-  print_info_boards(20, 10);
-  print_next_figure_boards(10);
-  print_score_boards(10);
-  print_control_boards(20, 10);
-  attrset(COLOR_PAIR(1));
-  refresh();
+// creates the game screen windows and draws their static content
+void create_windows(void) {
+  if (wins.board) return;
+
+  wins.board = newwin(BOARD_WIN_HEIGHT, BOARD_WIN_WIDTH, 0, 0);
+  wins.panel = newwin(BOARD_WIN_HEIGHT, PANEL_WIN_WIDTH, 0, BOARD_WIN_WIDTH);
+  wins.next = derwin(wins.panel, NEXT_WIN_HEIGHT, PANEL_WIN_WIDTH - 2, 1, 1);
+  wins.score = derwin(wins.panel, SCORE_WIN_HEIGHT, PANEL_WIN_WIDTH - 2,
+                      NEXT_WIN_HEIGHT + 2, 1);
+  wins.help = newwin(HELP_WIN_HEIGHT, BOARD_WIN_WIDTH + PANEL_WIN_WIDTH,
+                     BOARD_WIN_HEIGHT, 0);
+
+  wattrset(wins.board, COLOR_PAIR(1));
+  box(wins.board, 0, 0);
+  wattrset(wins.panel, COLOR_PAIR(1));
+  box(wins.panel, 0, 0);
+
+  wattrset(wins.next, COLOR_PAIR(1));
+  box(wins.next, 0, 0);
+  mvwprintw(wins.next, 0, 1, "-NEXT-FIGURE-");
+
+  wattrset(wins.score, COLOR_PAIR(1));
+  box(wins.score, 0, 0);
+  mvwprintw(wins.score, 0, 1, "-YOUR-SCORE-");
+  mvwaddch(wins.score, 2, 0, ACS_LTEE);
+  mvwhline(wins.score, 2, 1, ACS_HLINE, PANEL_WIN_WIDTH - 4);
+  mvwaddch(wins.score, 2, PANEL_WIN_WIDTH - 3, ACS_RTEE);
+  mvwprintw(wins.score, 2, 1, "-HIGH-SCORE-");
+
+  wattrset(wins.help, COLOR_PAIR(1));
+  box(wins.help, 0, 0);
+  print_help();
+
+  invalidate_field();
 }
 
-void print_corners(int y, int x) {
-  mvaddch(0, 0, ACS_ULCORNER);
-  mvaddch(0, x * 2 + 1, ACS_URCORNER);
-  mvaddch(y + 1, 0, ACS_LLCORNER);
-  mvaddch(y + 1, x * 2 + 1, ACS_LRCORNER);
-
-  mvaddch(1, x * 2 + 2, ACS_ULCORNER);
-  mvaddch(1, x * 2 + 16, ACS_URCORNER);
-  mvaddch(6, x * 2 + 2, ACS_LLCORNER);
-  mvaddch(6, x * 2 + 16, ACS_LRCORNER);
-
-  mvaddch(8, x * 2 + 2, ACS_ULCORNER);
-  mvaddch(8, x * 2 + 16, ACS_URCORNER);
-  mvaddch(9, x * 2 + 2, ACS_LLCORNER);
-  mvaddch(9, x * 2 + 16, ACS_LRCORNER);
-
-  mvaddch(11, x * 2 + 2, ACS_ULCORNER);
-  mvaddch(11, x * 2 + 16, ACS_URCORNER);
-  mvaddch(12, x * 2 + 2, ACS_LLCORNER);
-  mvaddch(12, x * 2 + 16, ACS_LRCORNER);
+void destroy_windows(void) {
+  WINDOW **all[] = {&wins.next, &wins.score, &wins.panel, &wins.board,
+                    &wins.help};
+  for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+    if (*all[i]) {
+      delwin(*all[i]);
+      *all[i] = NULL;
+    }
 }
 
-void print_field_boards(int y, int x) {
-  for (int i = 1; i <= x * 2; i++) {
-    mvaddch(0, i, ACS_HLINE);
-    mvaddch(y + 1, i, ACS_HLINE);
-  }
-
-  for (int i = 1; i <= y; i++) {
-    mvaddch(i, 0, ACS_VLINE);
-    mvaddch(i, x * 2 + 1, ACS_VLINE);
-  }
+// puts the game screen windows over whatever stdscr shows
+void showGameBoard() {
+  create_windows();
+  werase(stdscr);
+  wnoutrefresh(stdscr);
+  touchwin(wins.board);
+  touchwin(wins.panel);
+  touchwin(wins.help);
+  wnoutrefresh(wins.board);
+  wnoutrefresh(wins.panel);
+  wnoutrefresh(wins.help);
+  doupdate();
 }
 
-void print_info_boards(int y, int x) {
-  mvaddch(0, x * 2 + 17, ACS_URCORNER);
-  mvaddch(y + 1, x * 2 + 17, ACS_LRCORNER);
+void print_help() {
+  mvwprintw(wins.help, 1, 1, " ROTATING - \"A\"");
+  mvwprintw(wins.help, 2, 1, " MOVE DOWN/DROP - DOWN/UP KEY");
+  mvwprintw(wins.help, 3, 1, " MOVE LEFT/RIGHT - L/R ARROW KEY");
+  mvwprintw(wins.help, 4, 1, " PAUSE - \"P\"");
+}
 
-  for (int i = x * 2 + 2; i <= x * 2 + 16; i++) {
-    mvaddch(0, i, ACS_HLINE);
-    mvaddch(y + 1, i, ACS_HLINE);
-  }
+// forget the last drawn frame, the next print_field redraws everything
+void invalidate_field(void) { shown.valid = false; }
 
-  for (int i = 1; i <= y; i++) {
-    mvaddch(i, x * 2 + 17, ACS_VLINE);
+void init_cell_glyphs(void) {
+  cell_glyphs[0][0] = cell_glyphs[0][1] = ' ' | COLOR_PAIR(1);
+  for (int v = 1; v < CELL_VALUES; v++) {
+    cell_glyphs[v][0] = '[' | COLOR_PAIR(v + 1);
+    cell_glyphs[v][1] = ']' | COLOR_PAIR(v + 1);
   }
+  cell_glyphs[CELL_VALUES][0] = cell_glyphs[CELL_VALUES][1] =
+      ':' | COLOR_PAIR(1);
 }
 
-void print_next_figure_boards(int x) {
-  for (int i = x * 2 + 3; i < x * 2 + 16; i++) {
-    mvaddch(1, i, ACS_HLINE);
-    mvaddch(6, i, ACS_HLINE);
-  }
+// writes a row of cells with a single mvwaddchnstr call
+static void print_row(WINDOW *win, int y, int x, const int *cells, int n) {
+  chtype row[GAME_BOARD_WIDTH * 2];
 
-  for (int i = 1; i < 5; i++) {
-    mvaddch(1 + i, x * 2 + 2, ACS_VLINE);
-    mvaddch(1 + i, x * 2 + 16, ACS_VLINE);
+  for (int j = 0; j < n; j++) {
+    int v = (cells[j] > 0 && cells[j] < CELL_VALUES) ? cells[j] : 0;
+    if (cells[j] == TET_GHOST_CELL) v = CELL_VALUES;
+    row[j * 2] = cell_glyphs[v][0];
+    row[j * 2 + 1] = cell_glyphs[v][1];
   }
-
-  mvprintw(1, x * 2 + 3, "-NEXT-FIGURE-");
+  mvwaddchnstr(win, y, x, row, n * 2);
 }
 
-void print_score_boards(int x) {
-  mvprintw(8, x * 2 + 3, "-YOUR--SCORE-");
-  mvprintw(9, x * 2 + 6, "|GOOD*|");
-
-  for (int i = 3; i < 16; i++)
-    if (i < 6 || i > 12) mvaddch(9, x * 2 + i, ACS_HLINE);
-
-  mvprintw(12, x * 2 + 3, "-HIGH--SCORE-");
-  mvprintw(11, x * 2 + 6, "|*LUCK|");
+// draws only the rows of the field and next figure and the scores changed
+// since the last call and refreshes only the windows that got new content
+void print_field(const GameInfo_t *info) {
+  bool board = false, next = false, score = false;
 
-  for (int i = 3; i < 16; i++)
-    if (i < 6 || i > 12) mvaddch(11, x * 2 + i, ACS_HLINE);
-}
-
-void print_field(Game_t *game) {
-  // print_boards(20, 10);
-  //print_level(game->gameInfo->level, 10);
-
-  for (int i = 0; i < 20; i++)
-    for (int j = 0; j < 10; j++)
-      if (game->gameInfo->field[i][j])
-        mvprintw(1 + i, 1 + j * 2, "[]");
-      else
-        mvprintw(1 + i, 1 + j * 2, "  ");
-
-  for (int i = 0; i < 3; i++) mvprintw(3 + i, 10 * 2 + 3, "             ");
-  // int n = check_rang(game->gameInfo->next);
-  // for (int i = 0; i < 3; i++)
-  //   for (int j = 0; j < 4; j++)
-  //     if (next[i][j] == 1)
-  //       mvprintw(3 + i, (x * 2 + 2) + (7 - n) + j * 2, "[]");
-  //     else
-  //       mvprintw(3 + i, (x * 2 + 2) + (7 - n) + j * 2, "  ");
-
-  mvprintw(9, 10 * 2 + 7, "%d", game->gameInfo->score);
-  mvprintw(11, 10 * 2 + 7, "%d", game->gameInfo->high_score);
-
-  mvprintw(22, 1, " ROTATING - \"A\"                   ");
-  mvprintw(23, 1, " MOVE DOWN - DOWN ARROW KEY         ");
-  mvprintw(24, 1, " MOVE LEFT/RIGHT - L/R ARROW KEY    ");
-  mvprintw(25, 1, " PAUSE - \"P\"                      ");
-}
+  if (!info || !info->field) return;
+  create_windows();
 
-void print_control_boards(int y, int x) {
-  mvaddch(y + 6, 0, ACS_LLCORNER);
-  mvaddch(y + 6, x * 2 + 17, ACS_LRCORNER);
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    if (!shown.valid ||
+        memcmp(shown.field[i], info->field[i], sizeof(shown.field[i]))) {
+      print_row(wins.board, 1 + i, 1, info->field[i], GAME_BOARD_WIDTH);
+      memcpy(shown.field[i], info->field[i], sizeof(shown.field[i]));
+      board = true;
+    }
 
-  for (int i = 1; i < 6; i++) {
-    mvaddch(y + i, 0, ACS_VLINE);
-    mvaddch(y + i, x * 2 + 17, ACS_VLINE);
-  }
+  for (int i = 0; info->next && i < TET_SIDE_MAX; i++)
+    if (!shown.valid ||
+        memcmp(shown.next[i], info->next[i], sizeof(shown.next[i]))) {
+      print_row(wins.next, 1 + i, 3, info->next[i], TET_SIDE_MAX);
+      memcpy(shown.next[i], info->next[i], sizeof(shown.next[i]));
+      next = true;
+    }
 
-  for (int i = 1; i < x * 2 + 17; i++) {
-    mvaddch(y + 6, i, ACS_HLINE);
+  if (!shown.valid || shown.score != info->score ||
+      shown.high_score != info->high_score) {
+    wattrset(wins.score, COLOR_PAIR(1));
+    mvwprintw(wins.score, 1, 1, " %-11d", info->score);
+    mvwprintw(wins.score, 3, 1, " %-11d", info->high_score);
+    score = true;
   }
+  shown.score = info->score;
+  shown.high_score = info->high_score;
+  shown.valid = true;
+
+  if (board) wnoutrefresh(wins.board);
+  if (next) wnoutrefresh(wins.next);
+  if (score) wnoutrefresh(wins.score);
+  if (board || next || score) doupdate();
 }
 
+// pause message is shown inside the playfield window
 void showPauseScreen() {
-  clear_field(20, 40);
-
-  mvprintw(5, 5, "PRESS \"ENTER\"");
-  mvprintw(6, 5, "TO  CONTINUE");
-
-  mvprintw(11, 6, "PRESS \"ESC\"");
-  mvprintw(12, 7, "TO  EXIT");
+  create_windows();
+  wattrset(wins.board, COLOR_PAIR(1));
+  for (int i = 1; i <= GAME_BOARD_HEIGHT; i++)
+    mvwhline(wins.board, i, 1, ' ', GAME_BOARD_WIDTH * 2);
+
+  mvwprintw(wins.board, 5, 4, "PRESS \"ENTER\"");
+  mvwprintw(wins.board, 6, 4, "TO  CONTINUE");
+
+  mvwprintw(wins.board, 11, 5, "PRESS \"ESC\"");
+  mvwprintw(wins.board, 12, 6, "TO  EXIT");
+  invalidate_field();
+  wnoutrefresh(wins.board);
+  doupdate();
 }
-
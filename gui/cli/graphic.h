@@ -7,19 +7,30 @@
 // Initializator and deinitializator ncurses
 void initGraphics(void);
 void deinitGraphics(void);
-void gameRun(void);
 int enableColorMode(void);
 
+// Game screen layout: playfield, side panel with next figure and scores,
+// help below them
+#define BOARD_WIN_HEIGHT (GAME_BOARD_HEIGHT + 2)
+#define BOARD_WIN_WIDTH (GAME_BOARD_WIDTH * 2 + 2)
+#define PANEL_WIN_WIDTH 16
+#define NEXT_WIN_HEIGHT (TET_SIDE_MAX + 2)
+#define SCORE_WIN_HEIGHT 5
+#define HELP_WIN_HEIGHT 6
+
+// Number of cell values: empty cell and one color per figure
+#define CELL_VALUES (TET_COUNT + 1)
+
 void showSpalshScreen();
 void showMainMenu();
 void clear_field(int y, int x);
+void create_windows(void);
+void destroy_windows(void);
 void showGameBoard();
 void showPauseScreen();
-void print_corners(int y, int x);
-void print_field_boards(int y, int x);
-void print_info_boards(int y, int x);
-void print_next_figure_boards(int x);
-void print_score_boards(int x);
-void print_control_boards(int y, int x);
+void print_help();
+void init_cell_glyphs(void);
+void print_field(const GameInfo_t *info);
+void invalidate_field(void);
 
 #endif
\ No newline at end of file
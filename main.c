@@ -6,80 +6,636 @@
   \version 1
   \date September 2024
   Данный файл содержит в себе...
+
+  Параметры запуска:
+    --record файл  записать повтор игры в файл;
+    --replay файл  воспроизвести повтор в реальном времени;
+    --ansi         использовать интерфейс на ANSI-последовательностях вместо
+                   ncurses.
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "main.h"
 
-int main() {
+/*!
+  \brief Буфер байтов, прочитанных из терминала и еще не разобранных.
+*/
+static struct {
+  unsigned char data[64];  ///< Прочитанные байты.
+  int len;  ///< Количество прочитанных байтов.
+  int pos;  ///< Индекс следующего неразобранного байта.
+  bool kitty;  ///< Терминал подтвердил протокол клавиатуры kitty.
+} keys;
+
+/*!
+  \brief Функция инициализации интерфейса ncurses.
+  \return 0 - успешное выполнение, 1 - терминал не поддерживает цвета.
+*/
+static int cursesInit(void) {
   // Enable ncurses
   initGraphics();
-
   //enable cloring
-  if (enableColorMode() == OK) {
-    gameRun();
+  return enableColorMode() != OK;
+}
+
+/*!
+  \brief Функция отрисовки меню интерфейса ncurses.
+*/
+static void cursesShowMenu(void) {
+  clear();
+  showMainMenu();
+  refresh();
+}
+
+/*!
+  \brief Интерфейс на основе ncurses.
+*/
+static const Frontend_t cursesFrontend = {cursesInit,     deinitGraphics,
+                                         cursesShowMenu, showGameBoard,
+                                         showPauseScreen, print_field};
+
+/*!
+  \brief Интерфейс на основе ANSI-последовательностей без ncurses.
+*/
+static const Frontend_t ansiFrontend = {ansi_init,       ansi_deinit,
+                                       ansi_show_menu,  ansi_show_board,
+                                       ansi_show_pause, ansi_print_field};
+
+int main(int argc, char *argv[]) {
+  const char *recordPath = NULL, *replayPath = NULL;
+  const Frontend_t *frontend = &cursesFrontend;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--record") && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+      replayPath = argv[++i];
+    else if (!strcmp(argv[i], "--ansi"))
+      frontend = &ansiFrontend;
   }
 
-  //disable ncurses
-  deinitGraphics();
+  if (!frontend->init()) {
+    enableKeyboardProtocol();
+    if (replayPath)
+      replayShow(frontend, replayPath);
+    else
+      gameRun(frontend, recordPath);
+    disableKeyboardProtocol();
+  }
+
+  frontend->deinit();
 
   return 0;
-};
+}
+
+/*!
+  \brief Функция получения текущего момента времени.
+  \return Время CLOCK_MONOTONIC в наносекундах.
+*/
+static uint64_t monotonicNs(void) {
+  struct timespec now = {0};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+/*!
+  \brief Функция вычисления количества логических тактов между моментами
+  времени.
+  \param [in] from Начальный момент времени в наносекундах.
+  \param [in] to Конечный момент времени в наносекундах.
+  \return Количество полных тактов длительностью GAME_SPEED_DELAY мс.
+*/
+static uint64_t elapsedTicks(uint64_t from, uint64_t to) {
+  return to > from ? (to - from) / TICK_NSEC : 0;
+}
+
+/*!
+  \brief Функция вычисления интервала ожидания до заданного такта.
+  \param [in] base Момент времени нулевого такта в наносекундах.
+  \param [in] tick Номер такта относительно base.
+  \param [in] now Текущий момент времени в наносекундах.
+  \param [out] timeout Интервал ожидания (0, если такт уже наступил).
+*/
+static void tickTimeout(uint64_t base, uint64_t tick, uint64_t now,
+                        struct timespec *timeout) {
+  uint64_t deadline = base + tick * TICK_NSEC;
+  uint64_t ns = deadline > now ? deadline - now : 0;
+  timeout->tv_sec = (time_t)(ns / NSEC_PER_SEC);
+  timeout->tv_nsec = (long)(ns % NSEC_PER_SEC);
+}
+
+/*!
+  \brief Функция продвижения игры до заданного момента времени.
+  \param [in,out] game Указатель на структуру Game_t.
+  \param [in,out] base Момент времени нулевого такта в наносекундах.
+  \param [in,out] applied Количество выполненных тактов относительно base.
+  \param [in] time Момент времени в наносекундах.
+  \return true - если игра продвинулась хотя бы на один такт.
+
+  Если игра не развивается без действий пользователя, отсчет тактов
+  начинается заново от заданного момента.
+*/
+static bool advanceGame(Game_t *game, uint64_t *base, uint64_t *applied,
+                        uint64_t time) {
+  bool advanced = false;
+
+  if (ticksUntilEvent(game) < 0) {
+    if (time > *base) *base = time;
+    *applied = 0;
+  } else {
+    uint64_t due = elapsedTicks(*base, time);
+    if (due > *applied) {
+      tetris_step(game, None, (int)(due - *applied));
+      *applied = due;
+      advanced = true;
+    }
+  }
+
+  return advanced;
+}
+
+/*!
+  \brief Функция отрисовки экрана, соответствующего кадру игры.
+  \param [in] frontend Указатель на используемый интерфейс.
+  \param [in] frame Указатель на снимок кадра.
+  \param [in,out] screen Состояние, для которого отрисован текущий экран.
+
+  Меню и экран паузы отрисовываются только при смене состояния. Рамки игрового
+  экрана выводятся один раз, далее printField обновляет только изменившиеся
+  части.
+*/
+static void renderFrame(const Frontend_t *frontend, const GameFrame_t *frame,
+                        fsm_state_t *screen) {
+  if (frame->state == fsm_none && !frame->hasInfo) {
+    if (*screen != fsm_none) frontend->showMenu();
+    *screen = fsm_none;
+  } else if (frame->state == fsm_pause) {
+    if (*screen != fsm_pause) frontend->showPause();
+    *screen = fsm_pause;
+  } else if (frame->state != fsm_exit) {
+    if (*screen == fsm_none || *screen == fsm_exit) frontend->showBoard();
+    frontend->printField(&frame->info);
+    *screen = fsm_move;
+  }
+}
+
+/*!
+  \brief Функция публикации кадра игры для потока отрисовки.
+  \param [in,out] loop Указатель на структуру GameLoop_t.
+
+  Поток отрисовки пробуждается записью в канал уведомлений, если он еще не
+  был уведомлен о предыдущем кадре.
+*/
+static void publishFrame(GameLoop_t *loop) {
+  frameCapture(loop->game, frameBack(&loop->frames));
+  framePublish(&loop->frames);
+  if (!atomic_exchange(&loop->notified, true)) {
+    char signal = 1;
+    if (write(loop->frameFd, &signal, 1) < 0)
+      atomic_store(&loop->notified, false);
+  }
+}
+
+/*!
+  \brief Функция потока игровой логики.
+  \param [in,out] arg Указатель на структуру GameLoop_t.
+  \return NULL.
+
+  Поток не обращается к терминалу. Ожидание событий ввода выполняется функцией
+  pselect() на канале пробуждения с тайм-аутом до ближайшего события игры
+  (ticksUntilEvent()), а в меню и на паузе - без тайм-аута. После пробуждения
+  события извлекаются из очереди ввода, и перед каждым событием игра
+  продвигается функцией tetris_step() до такта, на котором была нажата
+  клавиша, поэтому задержка обработки не сдвигает действия во времени.
+  Действия помещаются в очередь событий игры и обрабатываются за один проход. Затем
+  игра продвигается до текущего момента по часам CLOCK_MONOTONIC. Отсчет
+  тактов начинается заново каждый раз, когда игра не развивается, поэтому
+  время в меню и на паузе не влияет на гравитацию. Каждое изменение игры
+  публикуется снимком кадра в тройной буфер.
+*/
+static void *logicRun(void *arg) {
+  GameLoop_t *loop = (GameLoop_t *)arg;
+  Game_t *game = loop->game;
+  struct timespec timeout = {0};
+  uint64_t base = monotonicNs(), applied = 0;
+  bool dirty = true;
+
+  while (game->core.state != fsm_exit) {
+    InputEvent_t event;
+    char signals[16];
+    int wait = 0;
+
+    while (read(loop->wakeFd, signals, sizeof(signals)) > 0) continue;
+    atomic_store(&loop->woken, false);
+    while (!inputQueuePop(&loop->input, &event)) {
+      advanceGame(game, &base, &applied, event.time);
+      //отпускание передается только для удерживаемых клавиш
+      if ((event.pressed || (game->core.heldKeys & HOLD_BIT(event.action))) &&
+          postUserInput(game, (UserAction_t)event.action, event.hold)) {
+        //заполненная очередь обрабатывается одним проходом до нового действия
+        dispatchEvents(game);
+        postUserInput(game, (UserAction_t)event.action, event.hold);
+      }
+      dirty = true;
+    }
+    dispatchEvents(game);
+    if (advanceGame(game, &base, &applied, monotonicNs())) dirty = true;
+
+    if (dirty) publishFrame(loop);
+    dirty = false;
+
+    if (game->core.state != fsm_exit) {
+      fd_set input;
+      FD_ZERO(&input);
+      FD_SET(loop->wakeFd, &input);
+      if ((wait = ticksUntilEvent(game)) >= 0)
+        tickTimeout(base, applied + (uint64_t)wait, monotonicNs(), &timeout);
+      pselect(loop->wakeFd + 1, &input, NULL, NULL, wait >= 0 ? &timeout : NULL,
+              NULL);
+    }
+  }
+  publishFrame(loop);
+
+  return NULL;
+}
+
+/*!
+  \brief Функция пробуждения потока логики.
+  \param [in,out] loop Указатель на структуру GameLoop_t.
+*/
+static void wakeLogic(GameLoop_t *loop) {
+  if (!atomic_exchange(&loop->woken, true)) {
+    char signal = 1;
+    if (write(loop->wakeSignalFd, &signal, 1) < 0)
+      atomic_store(&loop->woken, false);
+  }
+}
+
+/*!
+  \brief Функция добавления нажатия клавиши в очередь ввода.
+  \param [in,out] loop Указатель на структуру GameLoop_t.
+  \param [in] action Действие пользователя.
+  \param [in] pressed false - если клавиша отпущена.
+
+  Нажатие передается с признаком удержания, только если терминал сообщает об
+  отпускании клавиш (протокол kitty), иначе каждое нажатие, в том числе
+  автоповтор терминала, выполняется однократно. Если очередь заполнена, функция пробуждает поток логики и ожидает
+  освобождения места, поэтому нажатия не теряются.
+*/
+static void pushInput(GameLoop_t *loop, UserAction_t action, bool pressed) {
+  InputEvent_t event = {monotonicNs(), (uint8_t)action, pressed,
+                        pressed && keys.kitty};
+
+  while (inputQueuePush(&loop->input, &event)) {
+    struct timespec pause = {0, 100000};
+    wakeLogic(loop);
+    nanosleep(&pause, NULL);
+  }
+}
+
+/*!
+  \brief Функция потока ввода.
+  \param [in,out] arg Указатель на структуру GameLoop_t.
+  \return NULL.
+
+  Поток ожидает готовности терминала, считывает все доступные нажатия клавиш
+  и помещает их в очередь ввода с отметкой времени, после чего пробуждает
+  поток логики. Поток завершается при закрытии канала остановки, а при
+  закрытии терминала передает действие Terminate.
+*/
+static void *inputRun(void *arg) {
+  GameLoop_t *loop = (GameLoop_t *)arg;
+  bool stop = false;
+
+  while (!stop) {
+    fd_set input;
+    FD_ZERO(&input);
+    FD_SET(STDIN_FILENO, &input);
+    FD_SET(loop->stopFd, &input);
+    if (pselect(loop->stopFd + 1, &input, NULL, NULL, NULL, NULL) <= 0)
+      continue;
+    stop = FD_ISSET(loop->stopFd, &input);
+    if (!stop && FD_ISSET(STDIN_FILENO, &input)) {
+      UserAction_t action = None;
+      int count = 0;
+      bool pressed = true;
+      while (getUserInput(&action, &pressed)) {
+        if (action != None) pushInput(loop, action, pressed);
+        action = None;
+        count++;
+      }
+      //ввод готов, но не содержит данных - терминал закрыт
+      if (!count) {
+        pushInput(loop, Terminate, true);
+        stop = true;
+      }
+      wakeLogic(loop);
+    }
+  }
+
+  return NULL;
+}
+
+/*!
+  \brief Функция игрового цикла.
+  \param [in] frontend Указатель на используемый интерфейс.
+  \param [in] recordPath Путь к файлу записи повтора или NULL.
+
+  Игра выполняется тремя потоками: поток ввода (inputRun()) передает нажатия
+  клавиш через очередь ввода без блокировок, поток логики (logicRun())
+  изменяет игру и публикует кадры, а вызывающий поток владеет выводом в
+  терминал и по уведомлению отрисовывает самый новый кадр из тройного буфера.
+  Медленный вывод в терминал не задерживает гравитацию и обработку действий:
+  пропущенные кадры заменяются более новыми.
+*/
+void gameRun(const Frontend_t *frontend, const char *recordPath) {
+  static GameLoop_t loop;
+  ReplayWriter_t writer = {0};
+  fsm_state_t screen = fsm_exit;
+  int wakePipe[2] = {-1, -1}, framePipe[2] = {-1, -1}, stopPipe[2] = {-1, -1};
+  pthread_t logic, input;
+  bool done = false;
 
-void gameRun(void) {
-  createGame();
   //проверка предусловий
-  if (!locateGame(NULL)) {
-    return;
-  }
-  
-  int temp_time = 0;
-  int termrows = 0, termcols = 0;
-  getmaxyx(stdscr, termrows, termcols);
-  while (locateGame(NULL)->state != fsm_exit) {
-    if (locateGame(NULL)->state == fsm_none && !(locateGame(NULL)->gameInfo)) {
-      showMainMenu();
-    } else if (locateGame(NULL)->state == fsm_start) {
-      clear_field(termrows, termcols);
-      showGameBoard();
-      locateGame(NULL)->state = fsm_spawn;
-    } else if (locateGame(NULL)->state == fsm_spawn) {
-      // showGameBoard();
-      // showFigure();
-    } else if (locateGame(NULL)->state == fsm_pause) {
-      showPauseScreen();
-    } else if (locateGame(NULL)->state != fsm_none) {
-      temp_time += GAME_SPEED_DELAY;
+  if (!(loop.game = createGame())) return;
+  seedGame(loop.game, (uint64_t)time(NULL), SequenceBag7);
+  if (recordPath) replayOpenWrite(&writer, recordPath, loop.game);
+  frameBufferInit(&loop.frames);
+  inputQueueInit(&loop.input);
+  atomic_init(&loop.notified, false);
+  atomic_init(&loop.woken, false);
+
+  if (!pipe(wakePipe) && !pipe(framePipe) && !pipe(stopPipe)) {
+    fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(framePipe[0], F_SETFL, O_NONBLOCK);
+    loop.wakeFd = wakePipe[0];
+    loop.wakeSignalFd = wakePipe[1];
+    loop.frameFd = framePipe[1];
+    loop.stopFd = stopPipe[0];
+    done = pthread_create(&logic, NULL, logicRun, &loop) != 0;
+    if (!done && pthread_create(&input, NULL, inputRun, &loop)) {
+      //игрой владеет поток логики: без потока ввода Terminate передается
+      //через очередь ввода из вызывающего потока
+      pushInput(&loop, Terminate, true);
+      wakeLogic(&loop);
+      pthread_join(logic, NULL);
+      done = true;
+    }
+    while (!done) {
+      fd_set ready;
+      FD_ZERO(&ready);
+      FD_SET(framePipe[0], &ready);
+      if (pselect(framePipe[0] + 1, &ready, NULL, NULL, NULL, NULL) > 0) {
+        char signals[16];
+        bool fresh = false;
+        while (read(framePipe[0], signals, sizeof(signals)) > 0) continue;
+        atomic_store(&loop.notified, false);
+        const GameFrame_t *frame = frameAcquire(&loop.frames, &fresh);
+        if (fresh) renderFrame(frontend, frame, &screen);
+        if (frame->state == fsm_exit) {
+          close(stopPipe[1]);
+          stopPipe[1] = -1;
+          pthread_join(input, NULL);
+          pthread_join(logic, NULL);
+          done = true;
+        }
+      }
     }
-    UserAction_t action = {0};
-    int hold = false;
-    getUserInput(&action);
-    userInput(action, hold);
-    // if (temp_time >= GAME_SPEED_MAX_DELAY / locateGame(NULL)->gameInfo->speed && locateGame(NULL)->state != fsm_start) {
-    //   //Функция смещения фигуры вниз
-    //   temp_time = 0;
-    // }
   }
 
-  destroyGame(locateGame(NULL));
+  for (int i = 0; i < 2; i++) {
+    if (wakePipe[i] >= 0) close(wakePipe[i]);
+    if (framePipe[i] >= 0) close(framePipe[i]);
+    if (stopPipe[i] >= 0) close(stopPipe[i]);
+  }
+  if (recordPath) replayCloseWrite(&writer, loop.game);
+  destroyGame(loop.game);
+  loop.game = NULL;
 }
 
-void getUserInput(UserAction_t *action) {
-  int signal = wgetch(stdscr);
+/*!
+  \brief Функция воспроизведения повтора в реальном времени.
+  \param [in] frontend Указатель на используемый интерфейс.
+  \param [in] path Путь к файлу повтора.
+
+  Игра продвигается на один логический такт за время такта, записанное в
+  повторе, действия из повтора применяются на записанных тактах. Нажатие ESC
+  прерывает воспроизведение.
+*/
+void replayShow(const Frontend_t *frontend, const char *path) {
+  ReplayReader_t reader;
+  ReplayEvent_t event;
+  UserAction_t action = None;
+  Game_t *game = NULL;
+  bool more = false;
+
+  if (replayOpenRead(&reader, path)) return;
+  if ((game = createGameCtx()) && !replayPrepareGame(&reader, game)) {
+    struct timespec delay = {reader.header.tickMs / 1000,
+                             (long)(reader.header.tickMs % 1000) * 1000000L};
+    frontend->showBoard();
+    more = !replayReadEvent(&reader, &event);
+    while (more && action != Terminate) {
+      while (more && event.tick <= game->core.tick) {
+        if (event.action != None)
+          userInputCtx(game, event.action, event.hold);
+        more = !replayReadEvent(&reader, &event);
+      }
+      tetris_step(game, None, 1);
+      GameInfo_t info = updateCurrentStateCtx(game);
+      exportGhost(game, info.field);
+      frontend->printField(&info);
+      nanosleep(&delay, NULL);
+      while (getUserInput(&action, NULL) && action != Terminate) continue;
+    }
+  }
+  destroyGame(game);
+  replayCloseRead(&reader);
+}
+
+/*!
+  \brief Функция дочитывания байтов ввода в буфер.
+  \param [in] timeoutNs Наибольшее время ожидания ввода в наносекундах.
+  \return Количество прочитанных байтов, 0 - если ввод не поступил, -1 - если
+  терминал закрыт или буфер заполнен.
+
+  Ввод читается непосредственно из STDIN_FILENO, а не функциями ncurses,
+  поэтому чтение может выполняться в отдельном потоке независимо от вывода
+  в терминал. Неразобранные байты сдвигаются в начало буфера.
+*/
+static int readKeys(long timeoutNs) {
+  struct timespec timeout = {0, timeoutNs};
+  fd_set input;
+  int count = 0;
+
+  if (keys.pos > 0) {
+    memmove(keys.data, keys.data + keys.pos, (size_t)(keys.len - keys.pos));
+    keys.len -= keys.pos;
+    keys.pos = 0;
+  }
+  FD_ZERO(&input);
+  FD_SET(STDIN_FILENO, &input);
+  if (keys.len == (int)sizeof(keys.data)) {
+    count = -1;
+  } else if (pselect(STDIN_FILENO + 1, &input, NULL, NULL, &timeout, NULL) >
+             0) {
+    ssize_t n = read(STDIN_FILENO, keys.data + keys.len,
+                     sizeof(keys.data) - (size_t)keys.len);
+    count = n > 0 ? (int)n : -1;
+    if (n > 0) keys.len += (int)n;
+  }
+
+  return count;
+}
 
-  if (signal == KEY_UP)
+/*!
+  \brief Функция ожидания продолжения управляющей последовательности.
+  \param [in] need Индекс байта, который должен оказаться в буфере.
+  \return true - если байт прочитан до истечения тайм-аута.
+
+  Терминал передает последовательность одной записью, поэтому ее части
+  приходят с задержкой не больше долей миллисекунды. При включенном
+  протоколе клавиатуры kitty клавиша Esc передается последовательностью,
+  и одиночный байт ESC всегда является началом последовательности, поэтому
+  допустимо более долгое ожидание.
+*/
+static bool awaitKeys(int need) {
+  long timeout =
+      keys.kitty ? KITTY_SEQUENCE_TIMEOUT_NS : ESC_SEQUENCE_TIMEOUT_NS;
+
+  while (keys.pos + need >= keys.len && readKeys(timeout) > 0) continue;
+
+  return keys.pos + need < keys.len;
+}
+
+/*!
+  \brief Функция разбора последовательности CSI или SS3.
+  \param [in] seq Байты последовательности после ESC [ или ESC O.
+  \param [in] n Количество байтов, включая завершающий.
+  \param [out] action Действие пользователя, соответствующее клавише.
+  \param [out] pressed false - если последовательность сообщает об отпускании
+  клавиши.
+
+  Распознаются стрелки (CSI A-D, SS3 A-D, включая форму с модификаторами
+  CSI 1;mods:event A), клавиши протокола kitty (CSI code;mods:event u) и ответ
+  терминала на запрос протокола kitty (CSI ? flags u).
+*/
+static void parseSequence(const unsigned char *seq, int n,
+                          UserAction_t *action, bool *pressed) {
+  int params[2] = {0, 0}, event = 1, field = 0, sub = 0;
+  unsigned char final = seq[n - 1];
+
+  //поля разделяются ';', подполя - ':', тип события - второе подполе
+  //модификаторов
+  for (int i = 0; i < n - 1; i++) {
+    int digit = seq[i] - '0';
+    if (seq[i] == ';') {
+      field++;
+      sub = 0;
+    } else if (seq[i] == ':') {
+      if (field == 1 && ++sub == 1) event = 0;
+    } else if (digit >= 0 && digit <= 9 && field < 2 && sub == 0) {
+      params[field] = params[field] * 10 + digit;
+    } else if (digit >= 0 && digit <= 9 && field == 1 && sub == 1) {
+      event = event * 10 + digit;
+    }
+  }
+
+  if (seq[0] == '?' && final == 'u')
+    keys.kitty = params[0] != 0;
+  else if (final == 'A')
     *action = Up;
-  else if (signal == KEY_DOWN)
+  else if (final == 'B')
     *action = Down;
-  else if (signal == KEY_LEFT)
+  else if (final == 'D')
     *action = Left;
-  else if (signal == KEY_RIGHT)
+  else if (final == 'C')
     *action = Right;
-  else if (signal == ENTER_KEY)
-    *action = Start;
-  else if (signal == ESCAPE)
+  else if (final == 'u' && params[0] == ESCAPE)
     *action = Terminate;
-  else if (signal == 'P' || signal == 'p')
+  else if (final == 'u' && (params[0] == RETURN_KEY || params[0] == ENTER_KEY))
+    *action = Start;
+  else if (final == 'u' && (params[0] == 'p' || params[0] == 'P'))
     *action = Pause;
-  else if (signal == 'A' || signal == 'a')
+  else if (final == 'u' && (params[0] == 'a' || params[0] == 'A'))
     *action = Action;
-}
\ No newline at end of file
+  *pressed = event != KITTY_EVENT_RELEASE;
+}
+
+/*!
+  \brief Функция чтения одного события клавиатуры без ожидания.
+  \param [out] action Действие пользователя, соответствующее клавише. Для
+  клавиш без назначенного действия значение не изменяется.
+  \param [out] pressed false - если клавиша отпущена (только при включенном
+  протоколе клавиатуры kitty), может быть NULL.
+  \return 1 - если событие было прочитано, 0 - если ввод отсутствует.
+
+  Управляющие последовательности разбираются без ncurses и без ESCDELAY:
+  одиночный ESC считается нажатием клавиши Esc, только если за ним в течение
+  ESC_SEQUENCE_TIMEOUT_NS не поступило продолжение. Последовательность,
+  не завершившаяся за это время, отбрасывается.
+*/
+int getUserInput(UserAction_t *action, bool *pressed) {
+  int read_key = keys.pos < keys.len || readKeys(0) > 0;
+  bool down = true;
+
+  if (read_key) {
+    unsigned char signal = keys.data[keys.pos];
+    if (signal != ESCAPE) {
+      keys.pos++;
+      if (signal == ENTER_KEY || signal == RETURN_KEY)
+        *action = Start;
+      else if (signal == 'P' || signal == 'p')
+        *action = Pause;
+      else if (signal == 'A' || signal == 'a')
+        *action = Action;
+    } else if (!awaitKeys(1) || (keys.data[keys.pos + 1] != '[' &&
+                                 keys.data[keys.pos + 1] != 'O')) {
+      keys.pos++;
+      *action = Terminate;
+    } else {
+      int end = 2;
+      //параметры и промежуточные байты 0x20-0x3F, завершающий 0x40-0x7E
+      while (awaitKeys(end) && keys.data[keys.pos + end] >= 0x20 &&
+             keys.data[keys.pos + end] <= 0x3F)
+        end++;
+      if (keys.pos + end < keys.len) {
+        parseSequence(keys.data + keys.pos + 2, end - 1, action, &down);
+        keys.pos += end + 1;
+      } else {
+        keys.pos = keys.len;
+      }
+    }
+  }
+  if (pressed) *pressed = down;
+
+  return read_key;
+}
+
+/*!
+  \brief Функция включения протокола клавиатуры kitty.
+
+  Терминалу передается запрос на включение однозначных кодов клавиш и
+  сообщений об отпускании клавиш, а также запрос текущего режима. Терминалы
+  без поддержки протокола игнорируют оба запроса, и ввод разбирается по
+  тайм-ауту; ответ на запрос разбирается функцией getUserInput().
+*/
+void enableKeyboardProtocol(void) {
+  static const char request[] = "\033[>3u\033[?u";
+
+  if (isatty(STDOUT_FILENO) &&
+      write(STDOUT_FILENO, request, sizeof(request) - 1) < 0)
+    keys.kitty = false;
+}
+
+/*!
+  \brief Функция восстановления режима клавиатуры терминала.
+*/
+void disableKeyboardProtocol(void) {
+  static const char request[] = "\033[<u";
+
+  if (isatty(STDOUT_FILENO) &&
+      write(STDOUT_FILENO, request, sizeof(request) - 1) < 0)
+    keys.kitty = false;
+}
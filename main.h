@@ -1,8 +1,18 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/select.h>
 #include <time.h>
+#include <unistd.h>
+#include "./brick_game/tetris/frame.h"
+#include "./brick_game/tetris/input.h"
+#include "./brick_game/tetris/replay.h"
 #include "./brick_game/tetris/tetris.h"
+#include "./gui/ansi/ansi.h"
 #include "./gui/cli/graphic.h"
 
 
@@ -11,8 +21,52 @@
 
 #define ESCAPE 27
 #define ENTER_KEY 10
+#define RETURN_KEY 13
 
-void gameRun(void);
-void getUserInput(UserAction_t *action);
+// Ожидание продолжения последовательности после ESC, нс
+#define ESC_SEQUENCE_TIMEOUT_NS 500000L
+// То же при включенном протоколе клавиатуры kitty, нс
+#define KITTY_SEQUENCE_TIMEOUT_NS 50000000L
+// Тип события отпускания клавиши в протоколе kitty
+#define KITTY_EVENT_RELEASE 3
+
+#define NSEC_PER_SEC 1000000000LL
+#define TICK_NSEC ((uint64_t)GAME_SPEED_DELAY * 1000000u)
+
+/*!
+  \brief Структура интерфейса игры.
+
+  Игровой цикл обращается к терминалу только через функции интерфейса, что
+  позволяет выбирать реализацию при запуске.
+*/
+typedef struct Frontend_t {
+  int (*init)(void);  ///< Инициализация, 0 - успешное выполнение.
+  void (*deinit)(void);  ///< Восстановление состояния терминала.
+  void (*showMenu)(void);  ///< Отрисовка главного меню.
+  void (*showBoard)(void);  ///< Отрисовка рамок игрового экрана.
+  void (*showPause)(void);  ///< Отрисовка экрана паузы.
+  void (*printField)(const GameInfo_t *info);  ///< Отрисовка состояния игры.
+} Frontend_t;
+
+/*!
+  \brief Структура данных, разделяемых потоками ввода, логики и отрисовки.
+*/
+typedef struct GameLoop_t {
+  Game_t *game;  ///< Экземпляр игры, изменяемый только потоком логики.
+  FrameBuffer_t frames;  ///< Тройной буфер снимков кадра.
+  InputQueue_t input;  ///< Очередь событий ввода.
+  int wakeFd;  ///< Канал пробуждения потока логики (чтение).
+  int wakeSignalFd;  ///< Канал пробуждения потока логики (запись).
+  int frameFd;  ///< Канал уведомлений о новом кадре (запись в потоке логики).
+  int stopFd;  ///< Канал остановки потока ввода (чтение).
+  atomic_bool notified;  ///< Признак непрочитанного уведомления о кадре.
+  atomic_bool woken;  ///< Признак непрочитанного пробуждения потока логики.
+} GameLoop_t;
+
+void gameRun(const Frontend_t *frontend, const char *recordPath);
+void replayShow(const Frontend_t *frontend, const char *path);
+int getUserInput(UserAction_t *action, bool *pressed);
+void enableKeyboardProtocol(void);
+void disableKeyboardProtocol(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "./test_suitcases.h"
+
+#include <string.h>
+
+#include "../brick_game/tetris/batch.h"
+
+START_TEST(batch_same_results_on_any_workers) {
+  BatchConfig_t config;
+  BatchResult_t single, parallel;
+
+  initBatchConfig(&config);
+  config.games = 12;
+  config.seed = 3;
+  config.maxTicks = 200000;
+  config.workers = 1;
+  ck_assert_int_eq(runBatch(&config, &single), 0);
+  config.workers = 4;
+  ck_assert_int_eq(runBatch(&config, &parallel), 0);
+
+  ck_assert_int_eq(single.workers, 1);
+  ck_assert_int_eq(parallel.workers, 4);
+  ck_assert_int_eq(single.played, config.games);
+  ck_assert_int_eq(parallel.played, config.games);
+  for (int i = 0; i < config.games; i++)
+    ck_assert(single.results[i].ticks > 0);
+  ck_assert_mem_eq(single.results, parallel.results,
+                   sizeof(BatchGameResult_t) * (size_t)config.games);
+  ck_assert(single.pieces == parallel.pieces);
+  ck_assert(single.lines == parallel.lines);
+  ck_assert(single.ticks == parallel.ticks);
+  ck_assert(single.meanScore == parallel.meanScore);
+  ck_assert_int_eq(single.minScore, parallel.minScore);
+  ck_assert_int_eq(single.medianScore, parallel.medianScore);
+  ck_assert_int_eq(single.p90Score, parallel.p90Score);
+  ck_assert_int_eq(single.maxScore, parallel.maxScore);
+  freeBatchResult(&single);
+  freeBatchResult(&parallel);
+}
+END_TEST
+
+START_TEST(batch_summary_percentiles) {
+  BatchGameResult_t games[20];
+  BatchResult_t result;
+
+  memset(games, 0, sizeof(games));
+  for (int i = 0; i < 20; i++) {
+    games[i].score = (i * 7 % 20) * 100;
+    games[i].pieces = 1;
+  }
+  memset(&result, 0, sizeof(result));
+  result.games = 20;
+  result.results = games;
+  ck_assert_int_eq(summarizeBatch(&result), 0);
+  ck_assert_int_eq(result.minScore, 0);
+  ck_assert_int_eq(result.medianScore, 1000);
+  ck_assert_int_eq(result.p90Score, 1800);
+  ck_assert_int_eq(result.maxScore, 1900);
+  ck_assert(result.meanScore == 950.0);
+  ck_assert(result.pieces == 20);
+
+  memset(&result, 0, sizeof(result));
+  result.games = 1;
+  result.results = games + 1;
+  ck_assert_int_eq(summarizeBatch(&result), 0);
+  ck_assert_int_eq(result.p90Score, 700);
+  ck_assert_int_eq(result.medianScore, 700);
+
+  memset(&result, 0, sizeof(result));
+  ck_assert_int_eq(summarizeBatch(&result), 1);
+}
+END_TEST
+
+Suite *suite_batch() {
+  Suite *s = suite_create("batch");
+  TCase *tc = tcase_create("batch");
+
+  tcase_add_test(tc, batch_same_results_on_any_workers);
+  tcase_add_test(tc, batch_summary_percentiles);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
@@ -0,0 +1,158 @@
+#include "./test_suitcases.h"
+
+START_TEST(bitboard_set_get_cell) {
+  BitBoard_t board;
+  BoardColors_t colors;
+  bbClear(&board, &colors);
+  ck_assert_int_eq(bbSetCell(&board, &colors, 3, 4, 5), 0);
+  ck_assert_int_eq(bbGetCell(&board, &colors, 3, 4), 5);
+  ck_assert_int_eq(bbGetCell(&board, NULL, 3, 4), BB_DEFAULT_COLOR);
+  ck_assert_int_eq(BB_ROW_CELLS(&board, 3), 1 << 4);
+  ck_assert_int_eq(bbSetCell(&board, NULL, 3, 5, 2), 0);
+  ck_assert_int_eq(bbGetCell(&board, &colors, 3, 5), BB_DEFAULT_COLOR);
+  ck_assert_int_eq(bbSetCell(&board, &colors, 3, 4, 0), 0);
+  ck_assert_int_eq(BB_ROW_CELLS(&board, 3), 1 << 5);
+  ck_assert_int_eq(bbGetCell(&board, &colors, 3, 4), 0);
+  ck_assert_int_eq(bbSetCell(&board, &colors, GAME_BOARD_HEIGHT, 0, 1), 1);
+  ck_assert_int_eq(bbGetCell(&board, &colors, 0, GAME_BOARD_WIDTH), -1);
+}
+END_TEST
+
+START_TEST(bitboard_collision_walls_and_floor) {
+  BitBoard_t board;
+  const bbrow_t vertical[4] = {0x4, 0x4, 0x4, 0x4};
+  bbClear(&board, NULL);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, 0, -2), 0);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, 0, -3), 1);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, 0, GAME_BOARD_WIDTH - 3), 0);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, 0, GAME_BOARD_WIDTH - 2), 1);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, GAME_BOARD_HEIGHT - 4, 0),
+                   0);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, GAME_BOARD_HEIGHT - 3, 0),
+                   1);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, -BB_PAD, 0), 0);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, -BB_PAD, -3), 1);
+  ck_assert_int_eq(bbCollides(&board, vertical, 4, 0, -BB_PAD - 1), 1);
+}
+END_TEST
+
+START_TEST(bitboard_lock_and_full_row) {
+  BitBoard_t board;
+  BoardColors_t colors;
+  const bbrow_t line[1] = {0xF};
+  int **field = createGameField(GAME_BOARD_HEIGHT, GAME_BOARD_WIDTH);
+  bbClear(&board, &colors);
+  ck_assert_int_eq(
+      bbLock(&board, &colors, line, 1, GAME_BOARD_HEIGHT - 1, 0, 1), 0);
+  ck_assert_int_eq(
+      bbLock(&board, &colors, line, 1, GAME_BOARD_HEIGHT - 1, 4, 2), 0);
+  ck_assert_int_eq(bbIsRowFull(&board, GAME_BOARD_HEIGHT - 1), 0);
+  ck_assert_int_eq(bbCollides(&board, line, 1, GAME_BOARD_HEIGHT - 1, 5), 1);
+  ck_assert_int_eq(bbSetCell(&board, &colors, GAME_BOARD_HEIGHT - 1, 8, 3), 0);
+  ck_assert_int_eq(bbSetCell(&board, &colors, GAME_BOARD_HEIGHT - 1, 9, 3), 0);
+  ck_assert_int_eq(bbIsRowFull(&board, GAME_BOARD_HEIGHT - 1), 1);
+  bbExportField(&board, &colors, field);
+  ck_assert_int_eq(field[GAME_BOARD_HEIGHT - 1][0], 1);
+  ck_assert_int_eq(field[GAME_BOARD_HEIGHT - 1][5], 2);
+  ck_assert_int_eq(field[GAME_BOARD_HEIGHT - 1][9], 3);
+  ck_assert_int_eq(field[0][0], 0);
+  bbExportField(&board, NULL, field);
+  ck_assert_int_eq(field[GAME_BOARD_HEIGHT - 1][5], BB_DEFAULT_COLOR);
+  destroyGameField(field);
+}
+END_TEST
+
+START_TEST(bitboard_profile_tracks_board) {
+  BitBoard_t board;
+  BoardProfile_t profile, expected;
+  BoardRowSet_t full;
+  const bbrow_t roof[1] = {0x7}, tuck[1] = {0x3};
+  unsigned seed = 12345;
+  int cleared = 0;
+
+  bbClear(&board, NULL);
+  bbProfileBuild(&profile, &board);
+  ck_assert_int_eq(bbLock(&board, NULL, roof, 1, GAME_BOARD_HEIGHT - 3, 0, 1),
+                   0);
+  bbProfileLock(&profile, roof, 1, GAME_BOARD_HEIGHT - 3, 0);
+  ck_assert_int_eq(profile.heights[1], 3);
+  ck_assert_int_eq(profile.holes[1], 2);
+  ck_assert_int_eq(bbLock(&board, NULL, tuck, 1, GAME_BOARD_HEIGHT - 1, 0, 2),
+                   0);
+  bbProfileLock(&profile, tuck, 1, GAME_BOARD_HEIGHT - 1, 0);
+  ck_assert_int_eq(profile.holes[1], 1);
+  ck_assert_int_eq(profile.rowFill[GAME_BOARD_HEIGHT - 1], 2);
+
+  for (int i = 0; i < 2000; i++) {
+    const TetraminoShape_t *shape = NULL;
+    int row = 0, col = 0, lines = 0;
+    seed = seed * 1103515245u + 12345u;
+    shape = &tetraminoShapes[(seed >> 16) % TET_COUNT][(seed >> 8) % 4];
+    col = (int)((seed >> 20) %
+                (unsigned)(GAME_BOARD_WIDTH - shape->right + shape->left)) -
+          shape->left;
+    if (bbCollides(&board, shape->rows, TET_SIDE_MAX, row, col)) {
+      bbClear(&board, NULL);
+      bbProfileBuild(&profile, &board);
+      continue;
+    }
+    while (!bbCollides(&board, shape->rows, TET_SIDE_MAX, row + 1, col)) row++;
+    ck_assert_int_eq(
+        bbLock(&board, NULL, shape->rows, TET_SIDE_MAX, row, col, 1), 0);
+    bbProfileLock(&profile, shape->rows, TET_SIDE_MAX, row, col);
+    lines = bbClearFullRows(&board, NULL, &full);
+    ck_assert_int_eq(bbProfileClearRows(&profile, &board, &full), lines);
+    cleared += lines;
+    bbProfileBuild(&expected, &board);
+    ck_assert_mem_eq(&profile, &expected, sizeof(profile));
+  }
+  ck_assert_int_gt(cleared, 0);
+}
+END_TEST
+
+START_TEST(bitboard_clear_rows_mask) {
+  BitBoard_t board;
+  BoardColors_t colors;
+  BoardRowSet_t cleared;
+  const int full[] = {0, 7, 8, GAME_BOARD_HEIGHT - 3, GAME_BOARD_HEIGHT - 1};
+  const int count = (int)(sizeof(full) / sizeof(full[0]));
+  int expected[GAME_BOARD_HEIGHT] = {0}, kept = GAME_BOARD_HEIGHT;
+
+  bbClear(&board, &colors);
+  for (int row = 0; row < GAME_BOARD_HEIGHT; row++) {
+    board.rows[row + BB_PAD] = (bbrow_t)(BB_WALLS | ((row + 1) << BB_PAD));
+    colors.rows[row] = (bbcolor_t)row;
+  }
+  for (int i = 0; i < count; i++) board.rows[full[i] + BB_PAD] = BB_SOLID_ROW;
+  for (int row = GAME_BOARD_HEIGHT - 1; row >= 0; row--)
+    if (!bbIsRowFull(&board, row)) expected[--kept] = row + 1;
+
+  ck_assert_int_eq(bbClearFullRows(&board, &colors, &cleared), count);
+  for (int i = 0; i < count; i++)
+    ck_assert(cleared.words[full[i] / 64] & (UINT64_C(1) << (full[i] % 64)));
+  for (int row = 0; row < GAME_BOARD_HEIGHT; row++) {
+    ck_assert_int_eq(BB_ROW_CELLS(&board, row), expected[row]);
+    ck_assert_int_eq((int)colors.rows[row],
+                     expected[row] ? expected[row] - 1 : 0);
+  }
+  for (int row = -BB_PAD; row < count; row++)
+    ck_assert_int_eq(board.rows[row + BB_PAD], BB_WALLS);
+  ck_assert_int_eq(board.rows[BB_ROWS - 1], BB_SOLID_ROW);
+  ck_assert_int_eq(bbClearFullRows(&board, &colors, &cleared), 0);
+  ck_assert_int_eq(cleared.words[0], 0);
+}
+END_TEST
+
+Suite *suite_bitboard() {
+  Suite *s = suite_create("bitboard");
+  TCase *tc = tcase_create("bitboard");
+
+  tcase_add_test(tc, bitboard_set_get_cell);
+  tcase_add_test(tc, bitboard_collision_walls_and_floor);
+  tcase_add_test(tc, bitboard_lock_and_full_row);
+  tcase_add_test(tc, bitboard_profile_tracks_board);
+  tcase_add_test(tc, bitboard_clear_rows_mask);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
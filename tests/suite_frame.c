@@ -0,0 +1,82 @@
+#include <pthread.h>
+
+#include "./test_suitcases.h"
+
+#include "../brick_game/tetris/frame.h"
+
+#define FRAME_TEST_COUNT 20000
+
+START_TEST(frame_capture_matches_state) {
+  static FrameBuffer_t buffer;
+  Game_t *game = createGameCtx();
+  GameFrame_t *frame = NULL;
+  GameInfo_t info;
+
+  frameBufferInit(&buffer);
+  frame = frameBack(&buffer);
+  tetris_step(game, Start, 1);
+  tetris_step(game, Left, 30);
+  info = updateCurrentStateCtx(game);
+  exportGhost(game, info.field);
+  ck_assert_int_eq(frameCapture(game, frame), 0);
+  ck_assert_int_eq(frame->state, fsm_move);
+  ck_assert(frame->hasInfo);
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    ck_assert_mem_eq(frame->info.field[i], info.field[i],
+                     sizeof(int) * GAME_BOARD_WIDTH);
+  for (int i = 0; i < TET_SIDE_MAX; i++)
+    ck_assert_mem_eq(frame->info.next[i], info.next[i],
+                     sizeof(int) * TET_SIDE_MAX);
+  ck_assert_int_eq(frame->info.level, info.level);
+  destroyGame(game);
+}
+END_TEST
+
+static void *frameProducer(void *arg) {
+  FrameBuffer_t *buffer = (FrameBuffer_t *)arg;
+
+  for (int n = 1; n <= FRAME_TEST_COUNT; n++) {
+    GameFrame_t *frame = frameBack(buffer);
+    for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+      for (int j = 0; j < GAME_BOARD_WIDTH; j++) frame->field[i][j] = n;
+    frame->tick = (uint64_t)n;
+    framePublish(buffer);
+  }
+
+  return NULL;
+}
+
+START_TEST(frame_buffer_delivers_whole_frames) {
+  static FrameBuffer_t buffer;
+  pthread_t producer;
+  uint64_t last = 0;
+  bool torn = false;
+
+  frameBufferInit(&buffer);
+  ck_assert_int_eq(pthread_create(&producer, NULL, frameProducer, &buffer), 0);
+  while (last < FRAME_TEST_COUNT && !torn) {
+    bool fresh = false;
+    const GameFrame_t *frame = frameAcquire(&buffer, &fresh);
+    if (!fresh) continue;
+    torn = frame->tick <= last;
+    for (int i = 0; i < GAME_BOARD_HEIGHT && !torn; i++)
+      for (int j = 0; j < GAME_BOARD_WIDTH && !torn; j++)
+        torn = frame->field[i][j] != (int)frame->tick;
+    last = frame->tick;
+  }
+  pthread_join(producer, NULL);
+  ck_assert(!torn);
+  ck_assert_uint_eq(last, FRAME_TEST_COUNT);
+}
+END_TEST
+
+Suite *suite_frame() {
+  Suite *s = suite_create("frame");
+  TCase *tc = tcase_create("frame");
+
+  tcase_add_test(tc, frame_capture_matches_state);
+  tcase_add_test(tc, frame_buffer_delivers_whole_frames);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
@@ -0,0 +1,70 @@
+#include <pthread.h>
+
+#include "./test_suitcases.h"
+
+#include "../brick_game/tetris/input.h"
+
+#define INPUT_TEST_COUNT 100000
+
+START_TEST(input_queue_keeps_order) {
+  static InputQueue_t queue;
+  InputEvent_t event = {0};
+
+  inputQueueInit(&queue);
+  ck_assert_int_eq(inputQueuePop(&queue, &event), 1);
+  for (int i = 0; i < INPUT_QUEUE_SIZE; i++) {
+    event.time = (uint64_t)i;
+    event.action = (uint8_t)(i % (Action + 1));
+    ck_assert_int_eq(inputQueuePush(&queue, &event), 0);
+  }
+  ck_assert_int_eq(inputQueuePush(&queue, &event), 1);
+  for (int i = 0; i < INPUT_QUEUE_SIZE; i++) {
+    ck_assert_int_eq(inputQueuePop(&queue, &event), 0);
+    ck_assert_uint_eq(event.time, (uint64_t)i);
+    ck_assert_int_eq(event.action, i % (Action + 1));
+  }
+  ck_assert_int_eq(inputQueuePop(&queue, &event), 1);
+}
+END_TEST
+
+static void *inputProducer(void *arg) {
+  InputQueue_t *queue = (InputQueue_t *)arg;
+
+  for (int n = 1; n <= INPUT_TEST_COUNT; n++) {
+    InputEvent_t event = {(uint64_t)n, (uint8_t)(n % (Action + 1)), 1, 0};
+    while (inputQueuePush(queue, &event)) continue;
+  }
+
+  return NULL;
+}
+
+START_TEST(input_queue_passes_events_between_threads) {
+  static InputQueue_t queue;
+  pthread_t producer;
+  uint64_t last = 0;
+  bool lost = false;
+
+  inputQueueInit(&queue);
+  ck_assert_int_eq(pthread_create(&producer, NULL, inputProducer, &queue), 0);
+  while (last < INPUT_TEST_COUNT && !lost) {
+    InputEvent_t event;
+    if (inputQueuePop(&queue, &event)) continue;
+    lost = event.time != last + 1 || event.action != event.time % (Action + 1);
+    last = event.time;
+  }
+  pthread_join(producer, NULL);
+  ck_assert(!lost);
+  ck_assert_uint_eq(last, INPUT_TEST_COUNT);
+}
+END_TEST
+
+Suite *suite_input() {
+  Suite *s = suite_create("input");
+  TCase *tc = tcase_create("input");
+
+  tcase_add_test(tc, input_queue_keeps_order);
+  tcase_add_test(tc, input_queue_passes_events_between_threads);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
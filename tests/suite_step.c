@@ -0,0 +1,442 @@
+#include "./test_suitcases.h"
+
+#include "../brick_game/tetris/replay.h"
+#include "../brick_game/tetris/snapshot.h"
+
+START_TEST(step_spawn_and_gravity) {
+  Game_t *game = createGame();
+  ck_assert_int_eq(tetris_step(game, Start, 0), fsm_start);
+  ck_assert_int_eq(tetris_step(game, None, 1), fsm_move);
+  int row = game->curTetState->offsetRow;
+  tetris_step(game, None, ticksUntilEvent(game) - 1);
+  ck_assert_int_eq(game->curTetState->offsetRow, row);
+  tetris_step(game, None, 1);
+  ck_assert_int_eq(game->curTetState->offsetRow, row + 1);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_lock_and_spawn) {
+  Game_t *game = createGame();
+  tetris_step(game, Start, 1);
+  game->core.nextTetIndex = O_TYPE;
+  while (game->core.pieces == 0) tetris_step(game, None, 1);
+  ck_assert_int_eq(game->core.state, fsm_move);
+  ck_assert_int_eq(game->curTetState->tetraminoIndex, O_TYPE);
+  ck_assert_int_ne(BB_ROW_CELLS(&game->core.board, GAME_BOARD_HEIGHT - 1), 0);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_pause_freezes_ticks) {
+  Game_t *game = createGame();
+  tetris_step(game, Start, 1);
+  int row = game->curTetState->offsetRow;
+  ck_assert_int_eq(tetris_step(game, Pause, 1000), fsm_pause);
+  ck_assert_int_eq(game->curTetState->offsetRow, row);
+  ck_assert_int_eq(tetris_step(game, Pause, 0), fsm_move);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_same_seed_same_game) {
+  Game_t *first = createGameCtx();
+  Game_t *second = createGameCtx();
+  const UserAction_t actions[] = {Left, Action, Right, Down, None, Right};
+
+  seedGame(first, 42, SequenceHistory);
+  seedGame(second, 42, SequenceHistory);
+  tetris_step(first, Start, 0);
+  tetris_step(second, Start, 0);
+  for (int i = 0; i < 5000; i++) {
+    tetris_step(first, actions[i % 6], 7);
+    tetris_step(second, actions[i % 6], 7);
+  }
+  ck_assert_int_eq(first->core.pieces, second->core.pieces);
+  ck_assert_int_eq(first->core.state, second->core.state);
+  ck_assert_mem_eq(&first->core.board, &second->core.board, sizeof(BitBoard_t));
+  destroyGame(first);
+  destroyGame(second);
+}
+END_TEST
+
+START_TEST(step_bag_contains_every_piece) {
+  TetSequence_t sequence;
+  uint8_t pieces[TET_COUNT * 3];
+
+  sequenceInit(&sequence, 7, SequenceBag7);
+  sequenceNext(&sequence);
+  sequenceFill(&sequence, pieces, TET_COUNT * 3);
+  for (int bag = 0; bag < 2; bag++) {
+    int seen = 0;
+    for (int i = TET_COUNT - 1; i < 2 * TET_COUNT - 1; i++)
+      seen |= 1 << pieces[bag * TET_COUNT + i];
+    ck_assert_int_eq(seen, (1 << TET_COUNT) - 1);
+  }
+}
+END_TEST
+
+START_TEST(step_first_bag_after_start) {
+  Game_t *game = createGameCtx();
+  int seen = 0;
+
+  seedGame(game, 11, SequenceBag7);
+  tetris_step(game, Start, 1);
+  for (int i = 0; i < TET_COUNT; i++) {
+    ck_assert_int_eq(game->core.pieces, i);
+    seen |= 1 << game->curTetState->tetraminoIndex;
+    tetris_step(game, Up, 0);
+  }
+  ck_assert_int_eq(seen, (1 << TET_COUNT) - 1);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_replay_reproduces_game) {
+  const char *path = "test_step_replay.s21r";
+  Game_t *recorded = createGameCtx();
+  Game_t *played = createGameCtx();
+  const UserAction_t actions[] = {Left, Left, Action, Down, Right, None};
+  ReplayWriter_t writer;
+  ReplayReader_t reader;
+
+  seedGame(recorded, 99, SequenceBag7);
+  ck_assert_int_eq(replayOpenWrite(&writer, path, recorded), 0);
+  tetris_step(recorded, Start, 3);
+  for (int i = 0; i < 3000; i++) tetris_step(recorded, actions[i % 6], i % 4);
+  ck_assert_int_eq(replayCloseWrite(&writer, recorded), 0);
+
+  ck_assert_int_eq(replayOpenRead(&reader, path), 0);
+  ck_assert_int_eq(replayPlay(&reader, played), 0);
+  replayCloseRead(&reader);
+  ck_assert_uint_eq(played->core.tick, recorded->core.tick);
+  ck_assert_int_eq(played->core.pieces, recorded->core.pieces);
+  ck_assert_mem_eq(&played->core.board, &recorded->core.board,
+                   sizeof(BitBoard_t));
+  remove(path);
+  destroyGame(recorded);
+  destroyGame(played);
+}
+END_TEST
+
+START_TEST(step_snapshot_restores_game) {
+  Game_t *game = createGameCtx();
+  Game_t *clone = createGameCtx();
+  const UserAction_t actions[] = {Left, Action, Right, Down, None};
+  GameSnapshot_t snapshot, copy, after, idle;
+
+  ck_assert_int_eq(snapshotGame(clone, &idle), 0);
+  seedGame(game, 5, SequenceHistory);
+  tetris_step(game, Start, 1);
+  for (int i = 0; i < 500; i++) tetris_step(game, actions[i % 5], i % 3);
+  ck_assert_int_eq(snapshotGame(game, &snapshot), 0);
+  ck_assert_mem_eq(&snapshot, &game->core, sizeof(GameSnapshot_t));
+  copy = snapshot;
+  for (int i = 0; i < 500; i++) tetris_step(game, actions[i % 5], 2);
+  ck_assert_int_eq(snapshotGame(game, &after), 0);
+
+  ck_assert_int_eq(restoreGame(clone, &copy), 0);
+  ck_assert_ptr_eq(clone->curTetState, &clone->core.piece);
+  ck_assert_ptr_eq(clone->gameInfo, &((GameArena_t *)clone)->info);
+  ck_assert_mem_eq(&clone->core.clearedRows, &copy.clearedRows,
+                   sizeof(BoardRowSet_t));
+  ck_assert_int_eq(restoreGame(game, &idle), 0);
+  ck_assert_ptr_null(game->curTetState);
+  ck_assert_ptr_null(game->gameInfo);
+  ck_assert_int_eq(restoreGame(game, &snapshot), 0);
+  for (int i = 0; i < 500; i++) {
+    tetris_step(game, actions[i % 5], 2);
+    tetris_step(clone, actions[i % 5], 2);
+  }
+  ck_assert_int_eq(snapshotGame(game, &snapshot), 0);
+  ck_assert_int_eq(snapshotGame(clone, &copy), 0);
+  ck_assert_mem_eq(&snapshot, &after, sizeof(GameSnapshot_t));
+  ck_assert_mem_eq(&copy, &after, sizeof(GameSnapshot_t));
+  destroyGame(game);
+  destroyGame(clone);
+}
+END_TEST
+
+START_TEST(step_arena_relocation) {
+  static GameArena_t first, second;
+  Game_t *game = createGameIn(&first, sizeof(first));
+  Game_t *reference = createGameCtx();
+  GameSnapshot_t expected, actual;
+
+  ck_assert_ptr_null(createGameIn((char *)&second + 1, sizeof(second)));
+  ck_assert_ptr_eq(game, &first.game);
+  tetris_step(game, Start, 1);
+  tetris_step(reference, Start, 1);
+  for (int i = 0; i < 300; i++) {
+    tetris_step(game, i % 2 ? Left : Action, 3);
+    tetris_step(reference, i % 2 ? Left : Action, 3);
+  }
+  game = relocateGame(game, &second, sizeof(second));
+  ck_assert_ptr_eq(game, &second.game);
+  ck_assert_ptr_eq(game->gameInfo->field[1],
+                   second.fieldCells + GAME_BOARD_WIDTH);
+  tetris_step(game, Down, 50);
+  tetris_step(reference, Down, 50);
+  updateCurrentStateCtx(game);
+  snapshotGame(game, &actual);
+  snapshotGame(reference, &expected);
+  ck_assert_mem_eq(&actual, &expected, sizeof(GameSnapshot_t));
+  destroyGame(game);
+  destroyGame(reference);
+}
+END_TEST
+
+START_TEST(step_ticks_until_event) {
+  Game_t *game = createGameCtx();
+  ck_assert_int_eq(ticksUntilEvent(game), -1);
+  tetris_step(game, Start, 0);
+  ck_assert_int_eq(ticksUntilEvent(game), 1);
+  tetris_step(game, None, 1);
+  int row = game->curTetState->offsetRow;
+  int wait = ticksUntilEvent(game);
+  tetris_step(game, None, wait - 1);
+  ck_assert_int_eq(game->curTetState->offsetRow, row);
+  tetris_step(game, None, 1);
+  ck_assert_int_eq(game->curTetState->offsetRow, row + 1);
+  tetris_step(game, Pause, 0);
+  ck_assert_int_eq(ticksUntilEvent(game), -1);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_auto_shift) {
+  Game_t *game = createGameCtx();
+  tetris_step(game, Start, 1);
+  ck_assert_int_eq(setAutoShift(game, 6, 2), 0);
+  int col = game->curTetState->offsetCol;
+  userInputCtx(game, Left, true);
+  ck_assert_int_eq(game->curTetState->offsetCol, col - 1);
+  userInputCtx(game, Left, true);
+  tetris_step(game, None, 5);
+  ck_assert_int_eq(game->curTetState->offsetCol, col - 1);
+  ck_assert_int_eq(ticksUntilEvent(game), 1);
+  tetris_step(game, None, 1);
+  ck_assert_int_eq(game->curTetState->offsetCol, col - 2);
+  tetris_step(game, None, 2);
+  ck_assert_int_eq(game->curTetState->offsetCol, col - 3);
+  userInputCtx(game, Left, false);
+  col = game->curTetState->offsetCol;
+  tetris_step(game, None, 20);
+  ck_assert_int_eq(game->curTetState->offsetCol, col);
+  ck_assert_int_eq(setAutoShift(game, 0, 0), 0);
+  userInputCtx(game, Right, true);
+  tetris_step(game, None, 1);
+  const TetraminoShape_t *shape = getTetraminoShape(
+      game->curTetState->tetraminoIndex, game->curTetState->orientation);
+  ck_assert_int_eq(game->curTetState->offsetCol + shape->right,
+                   GAME_BOARD_WIDTH - 1);
+  userInputCtx(game, Right, false);
+  userInputCtx(game, Left, false);
+  ck_assert_int_eq(game->curTetState->offsetCol + shape->right,
+                   GAME_BOARD_WIDTH - 2);
+  ck_assert_int_eq(setAutoShift(game, -1, 0), 1);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_gravity_table) {
+  Game_t *game = createGameCtx();
+  tetris_step(game, Start, 1);
+  game->core.score = GAME_LEVEL_SCORE * 14;
+  updateLevel(game);
+  ck_assert_int_eq(game->core.level, 15);
+  int row = game->curTetState->offsetRow;
+  tetris_step(game, None, 1);
+  ck_assert_int_eq(game->curTetState->offsetRow, row + 1);
+  tetris_step(game, None, 2);
+  ck_assert_int_eq(game->curTetState->offsetRow, row + 4);
+  game->core.score = GAME_LEVEL_SCORE * 100;
+  updateLevel(game);
+  ck_assert_int_eq(game->core.level, GAME_SPEED_MAX);
+  ck_assert_int_eq(game->core.gravity, GAME_GRAVITY_20G);
+  tetris_step(game, None, 1);
+  const TetraminoShape_t *shape = getTetraminoShape(
+      game->curTetState->tetraminoIndex, game->curTetState->orientation);
+  ck_assert_int_eq(game->curTetState->offsetRow + shape->bottom,
+                   GAME_BOARD_HEIGHT - 1);
+  ck_assert_int_eq(game->core.lockTimer, game->core.lockTicks);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_lock_delay) {
+  Game_t *game = createGameCtx();
+  ck_assert_int_eq(setLockDelay(game, 10, 2), 0);
+  tetris_step(game, Start, 1);
+  game->core.gravity = GAME_GRAVITY_20G;
+  tetris_step(game, None, 1);
+  ck_assert_int_eq(ticksUntilEvent(game), 10);
+  tetris_step(game, None, 9);
+  tetris_step(game, Left, 9);
+  tetris_step(game, Right, 9);
+  ck_assert_int_eq(game->core.pieces, 0);
+  tetris_step(game, Left, 1);
+  ck_assert_int_eq(game->core.pieces, 1);
+  ck_assert_int_eq(game->core.lockLatency, 28);
+  ck_assert_int_ne(BB_ROW_CELLS(&game->core.board, GAME_BOARD_HEIGHT - 1), 0);
+  ck_assert_int_eq(setLockDelay(game, 0, -1), 1);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_event_queue) {
+  Game_t *game = createGameCtx();
+  int rejected = 0;
+  ck_assert(fsm(fsm_exit, Start) == NULL);
+  ck_assert(fsm(fsm_move, FsmTick) == move_fn);
+  ck_assert(fsm(fsm_connect, FsmLock) == connect_fn);
+  tetris_step(game, Start, 1);
+  int col = game->curTetState->offsetCol;
+  postUserInput(game, Left, false);
+  postUserInput(game, Left, false);
+  ck_assert_int_eq(game->curTetState->offsetCol, col);
+  dispatchEvents(game);
+  ck_assert_int_eq(game->curTetState->offsetCol, col - 2);
+  ck_assert_int_eq(postEvent(game, FsmEventCount), 1);
+  for (int i = 0; i < GAME_EVENT_QUEUE + 4; i++)
+    rejected += postUserInput(game, Right, false);
+  ck_assert_int_eq(rejected, 4);
+  ck_assert_int_eq(game->core.eventCount, GAME_EVENT_QUEUE);
+  ck_assert_int_eq(postEvent(game, FsmTick), 1);
+  ck_assert_int_eq(game->core.eventCount, GAME_EVENT_QUEUE);
+  dispatchEvents(game);
+  const TetraminoShape_t *shape = getTetraminoShape(
+      game->curTetState->tetraminoIndex, game->curTetState->orientation);
+  ck_assert_int_eq(game->curTetState->offsetCol + shape->right,
+                   GAME_BOARD_WIDTH - 1);
+  ck_assert_int_eq(game->core.eventCount, 0);
+  for (int i = 0; i < GAME_EVENT_QUEUE; i++) postUserInput(game, Left, false);
+  userInputCtx(game, Left, false);
+  ck_assert_int_eq(game->curTetState->offsetCol + shape->left, 0);
+  ck_assert_int_eq(game->core.eventCount, 0);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_hard_drop_and_ghost) {
+  Game_t *game = createGame();
+  int **field = createGameField(GAME_BOARD_HEIGHT, GAME_BOARD_WIDTH);
+  const TetraminoShape_t *shape = NULL;
+  int ghosts = 0, row = 0;
+
+  tetris_step(game, Start, 1);
+  shape = getTetraminoShape(game->curTetState->tetraminoIndex,
+                            game->curTetState->orientation);
+  ck_assert_int_eq(getGhostRow(game) + shape->bottom, GAME_BOARD_HEIGHT - 1);
+  exportGameField(game, field, NULL);
+  exportGhost(game, field);
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    for (int j = 0; j < GAME_BOARD_WIDTH; j++)
+      ghosts += field[i][j] == TET_GHOST_CELL;
+  ck_assert_int_eq(ghosts, TET_CELLS);
+
+  tetris_step(game, Up, 0);
+  ck_assert_int_eq(game->core.pieces, 1);
+  ck_assert_int_eq(game->core.lockLatency, 0);
+  ck_assert_int_ne(BB_ROW_CELLS(&game->core.board, GAME_BOARD_HEIGHT - 1), 0);
+  ck_assert_int_eq(game->core.state, fsm_move);
+
+  for (int i = 0; i < 3; i++) tetris_step(game, Left, 0);
+  tetris_step(game, Action, 0);
+  row = game->curTetState->offsetRow;
+  while (!checkBoardCollision(&game->core.board, game->curTetState))
+    game->curTetState->offsetRow++;
+  ck_assert_int_eq(getGhostRow(game), game->curTetState->offsetRow - 1);
+  game->curTetState->offsetRow = row;
+
+  tetris_step(game, Pause, 1);
+  ck_assert_int_eq(getGhostRow(game), -1);
+  destroyGameField(field);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_lock_out_above_field) {
+  Game_t *game = createGame();
+  const TetraminoShape_t *shape = NULL;
+
+  tetris_step(game, Start, 1);
+  shape = getTetraminoShape(game->curTetState->tetraminoIndex,
+                            game->curTetState->orientation);
+  game->curTetState->offsetRow = -shape->top - 1;
+  game->core.ghostRow = game->curTetState->offsetRow;
+  ck_assert_int_eq(tetris_step(game, Up, 0), fsm_gameover);
+  ck_assert_int_eq(game->core.pieces, 0);
+  ck_assert_int_eq(game->core.score, 0);
+  for (int i = 0; i < GAME_BOARD_HEIGHT; i++)
+    ck_assert_int_eq(BB_ROW_CELLS(&game->core.board, i), 0);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_lock_reset_on_reground) {
+  Game_t *game = createGameCtx();
+  int cycles = 0;
+
+  ck_assert_int_eq(setLockDelay(game, 10, 2), 0);
+  tetris_step(game, Start, 0);
+  game->core.nextTetIndex = I_TYPE;
+  tetris_step(game, None, 1);
+  tetris_step(game, Action, 0);
+  while (game->curTetState->offsetRow < getGhostRow(game))
+    tetris_step(game, Down, 0);
+  ck_assert_int_eq(game->core.lockTimer, 10);
+  while (game->core.pieces == 0 && cycles < 10) {
+    tetris_step(game, Action, 0);
+    ck_assert_int_lt(game->curTetState->offsetRow, getGhostRow(game));
+    tetris_step(game, Action, 5);
+    cycles++;
+  }
+  ck_assert_int_eq(game->core.pieces, 1);
+  ck_assert_int_eq(cycles, 3);
+  destroyGame(game);
+}
+END_TEST
+
+START_TEST(step_lock_without_delay) {
+  Game_t *game = createGameCtx();
+
+  ck_assert_int_eq(setLockDelay(game, 0, 0), 0);
+  tetris_step(game, Start, 1);
+  while (game->curTetState->offsetRow < getGhostRow(game))
+    tetris_step(game, Down, 0);
+  tetris_step(game, Left, 1);
+  ck_assert_int_eq(game->core.pieces, 0);
+  ck_assert_int_lt(game->core.lockTimer, 0);
+  tetris_step(game, None, ticksUntilEvent(game));
+  ck_assert_int_eq(game->core.pieces, 1);
+  destroyGame(game);
+}
+END_TEST
+
+Suite *suite_step() {
+  Suite *s = suite_create("step");
+  TCase *tc = tcase_create("step");
+
+  tcase_add_test(tc, step_spawn_and_gravity);
+  tcase_add_test(tc, step_lock_and_spawn);
+  tcase_add_test(tc, step_pause_freezes_ticks);
+  tcase_add_test(tc, step_same_seed_same_game);
+  tcase_add_test(tc, step_bag_contains_every_piece);
+  tcase_add_test(tc, step_first_bag_after_start);
+  tcase_add_test(tc, step_replay_reproduces_game);
+  tcase_add_test(tc, step_snapshot_restores_game);
+  tcase_add_test(tc, step_arena_relocation);
+  tcase_add_test(tc, step_ticks_until_event);
+  tcase_add_test(tc, step_auto_shift);
+  tcase_add_test(tc, step_gravity_table);
+  tcase_add_test(tc, step_lock_delay);
+  tcase_add_test(tc, step_lock_reset_on_reground);
+  tcase_add_test(tc, step_lock_without_delay);
+  tcase_add_test(tc, step_event_queue);
+  tcase_add_test(tc, step_hard_drop_and_ghost);
+  tcase_add_test(tc, step_lock_out_above_field);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
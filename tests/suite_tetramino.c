@@ -0,0 +1,72 @@
+#include "./test_suitcases.h"
+
+START_TEST(tetramino_table_matches_rotations) {
+  const Tetramino_t *tets = fillTatraminoes();
+
+  for (int t = 0; t < TET_COUNT; t++) {
+    int side = tets[t].side;
+    for (int o = 0; o < TET_ORIENT_COUNT; o++) {
+      const TetraminoShape_t *shape = getTetraminoShape(t, o);
+      int count = 0;
+      for (int i = 0; i < side; i++) {
+        for (int j = 0; j < side; j++) {
+          int val = 0;
+          if (o == ToTop)
+            val = tets[t].data[i * side + j];
+          else if (o == ToRight)
+            val = tets[t].data[(side - j - 1) * side + i];
+          else if (o == ToBottom)
+            val = tets[t].data[(side - i - 1) * side + (side - j - 1)];
+          else
+            val = tets[t].data[j * side + (side - i - 1)];
+          ck_assert_int_eq(!!(shape->rows[i] & (1 << j)), !!val);
+          if (val) {
+            ck_assert_int_eq(shape->cells[count].row, i);
+            ck_assert_int_eq(shape->cells[count].col, j);
+            count++;
+          }
+        }
+      }
+      ck_assert_int_eq(count, TET_CELLS);
+    }
+  }
+  ck_assert_ptr_null(getTetraminoShape(TET_COUNT, ToTop));
+}
+END_TEST
+
+START_TEST(tetramino_rotate_wraps) {
+  TetraminoState_t state = {T_TYPE, 0, 0, ToTop};
+  ck_assert_int_eq(rotateTetramino(&state, RotateCCwise), 0);
+  ck_assert_int_eq(state.orientation, ToLeft);
+  ck_assert_int_eq(rotateTetramino(&state, RotateCwise), 0);
+  ck_assert_int_eq(state.orientation, ToTop);
+  ck_assert_int_eq(rotateTetramino(NULL, RotateCwise), 1);
+}
+END_TEST
+
+START_TEST(tetramino_board_collision) {
+  BitBoard_t board;
+  TetraminoState_t state = {I_TYPE, 0, -2, ToRight};
+  bbClear(&board, NULL);
+  ck_assert_int_eq(checkBoardCollision(&board, &state), 0);
+  state.offsetCol = -3;
+  ck_assert_int_eq(checkBoardCollision(&board, &state), 1);
+  state.offsetCol = 0;
+  state.offsetRow = GAME_BOARD_HEIGHT - 4;
+  ck_assert_int_eq(checkBoardCollision(&board, &state), 0);
+  bbSetCell(&board, NULL, GAME_BOARD_HEIGHT - 1, 2, 1);
+  ck_assert_int_eq(checkBoardCollision(&board, &state), 1);
+}
+END_TEST
+
+Suite *suite_tetramino() {
+  Suite *s = suite_create("tetramino");
+  TCase *tc = tcase_create("tetramino");
+
+  tcase_add_test(tc, tetramino_table_matches_rotations);
+  tcase_add_test(tc, tetramino_rotate_wraps);
+  tcase_add_test(tc, tetramino_board_collision);
+  suite_add_tcase(s, tc);
+
+  return s;
+}
@@ -16,7 +16,8 @@ void run_testcase(Suite *testcase) {
 
 void run_tests() {
   Suite *list_cases[] = {
-      suite_gamecreate(), NULL};
+      suite_gamecreate(), suite_bitboard(), suite_tetramino(), suite_step(),
+      suite_frame(),      suite_input(),    suite_batch(), NULL};
 
   for (Suite **current_testcase = list_cases; *current_testcase != NULL;
        current_testcase++) {
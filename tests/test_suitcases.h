@@ -9,6 +9,12 @@
 
 
 Suite *suite_gamecreate();
+Suite *suite_bitboard();
+Suite *suite_tetramino();
+Suite *suite_step();
+Suite *suite_frame();
+Suite *suite_input();
+Suite *suite_batch();
 
 void run_tests();
 void run_testcase(Suite *testcase);